@@ -0,0 +1,29 @@
+#pragma once
+#include "lander_gnc.h"
+#include "lander_vision.h"
+#include "world_physics.h"
+
+//friend of GNC, Vision and WorldPhysics so the benchmarks can time private hot paths without changing their interfaces
+struct BenchmarkAccess{
+    static glm::vec3 zemZevControl(Lander::GNC& gnc, float timeStep, glm::vec3 sitePos, glm::vec3 siteUp, glm::vec3 angularVelocity){
+        return gnc.ZEM_ZEV_Control(timeStep, sitePos, siteUp, angularVelocity);
+    }
+    static glm::vec3 calculateVectorsAtTime(Lander::GNC& gnc, float time, glm::vec3 sitePos, glm::vec3 siteUp, glm::vec3 angularVelocity){
+        gnc.calculateVectorsAtTime(time, sitePos, siteUp, angularVelocity);
+        return gnc.projectedLandingSitePos;
+    }
+
+    static void detectFeatures(Lander::Vision& vision, cv::Mat optics){
+        vision.detectFeatures(optics);
+    }
+    static void featureMatch(Lander::Vision& vision){
+        vision.featureMatch();
+    }
+    static glm::vec3 findBestAngularVelocityMatchFromDecomp(Lander::Vision& vision, cv::Mat H){
+        return vision.findBestAngularVelocityMatchFromDecomp(H);
+    }
+
+    static void updateCollisionObjects(WorldPhysics& physics, float timeStep){
+        physics.updateCollisionObjects(timeStep);
+    }
+};
@@ -0,0 +1,109 @@
+#include "bench_harness.h"
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <ctime>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+//drops everything written to std::cout for its scope, put back even if a benchmark throws
+struct MuteCout{
+    std::streambuf* buffer = std::cout.rdbuf(nullptr); //badbit set, writes are dropped
+    ~MuteCout(){
+        std::cout.rdbuf(buffer);
+        std::cout.clear();
+    };
+};
+
+void Bench::Harness::run(const std::string& name, int samples, int callsPerSample, const std::function<void()>& body, const std::function<void()>& setup){
+    if(!filter.empty() && name.find(filter) == std::string::npos)
+        return;
+
+    std::cout << "Running " << name << "..." << std::endl;
+
+    std::vector<double> timings;
+    timings.reserve(samples);
+    {
+        MuteCout mute;
+        int warmup = std::max(1, samples/WARMUP_DIVISOR);
+        for(int s = -warmup; s < samples; s++){
+            if(setup)
+                setup();
+            auto start = std::chrono::steady_clock::now();
+            for(int c = 0; c < callsPerSample; c++)
+                body();
+            auto end = std::chrono::steady_clock::now();
+            if(s >= 0)
+                timings.push_back(std::chrono::duration<double, std::nano>(end - start).count()/callsPerSample);
+        }
+    }
+
+    Result result;
+    result.name = name;
+    result.samples = samples;
+    result.callsPerSample = callsPerSample;
+    result.meanNs = std::accumulate(timings.begin(), timings.end(), 0.0)/timings.size();
+    double variance = 0;
+    for(double t : timings)
+        variance += (t - result.meanNs)*(t - result.meanNs);
+    result.stddevNs = std::sqrt(variance/timings.size());
+    std::sort(timings.begin(), timings.end());
+    result.medianNs = timings[timings.size()/2];
+    result.minNs = timings.front();
+    result.maxNs = timings.back();
+    results.push_back(result);
+}
+
+void Bench::Harness::printSummary(){
+    std::cout << "\n" << std::left << std::setw(40) << "benchmark" << std::right
+              << std::setw(14) << "median ns" << std::setw(14) << "mean ns" << std::setw(14) << "stddev ns" << std::setw(14) << "min ns" << "\n";
+    for(const Result& r : results){
+        std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << r.medianNs << std::setw(14) << r.meanNs << std::setw(14) << r.stddevNs << std::setw(14) << r.minNs << "\n";
+    }
+}
+
+static std::string escapeJson(const std::string& s){
+    std::string out;
+    for(char c : s){
+        if(c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+//one object per run, benchmarks is keyed by name so runs from different releases can be diffed directly
+bool Bench::Harness::writeJson(const std::string& path){
+    std::ofstream file(path);
+    if(!file.is_open())
+        return false;
+
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    file << std::setprecision(10);
+    file << "{\n";
+    file << "  \"timestamp\": \"" << timestamp << "\",\n";
+    file << "  \"compiler\": \"" << escapeJson(__VERSION__) << "\",\n";
+    file << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "  \"benchmarks\": {";
+    for(size_t i = 0; i < results.size(); i++){
+        const Result& r = results[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    \"" << escapeJson(r.name) << "\": {"
+             << "\"samples\": " << r.samples
+             << ", \"calls_per_sample\": " << r.callsPerSample
+             << ", \"median_ns\": " << r.medianNs
+             << ", \"mean_ns\": " << r.meanNs
+             << ", \"stddev_ns\": " << r.stddevNs
+             << ", \"min_ns\": " << r.minNs
+             << ", \"max_ns\": " << r.maxNs << "}";
+    }
+    file << "\n  }\n}\n";
+    return file.good();
+}
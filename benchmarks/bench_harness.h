@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace Bench{
+
+//timings for one benchmark, all times are per call in nanoseconds
+struct Result{
+    std::string name;
+    int samples;
+    int callsPerSample;
+    double meanNs;
+    double medianNs;
+    double minNs;
+    double maxNs;
+    double stddevNs;
+};
+
+//minimal timing harness, no external benchmark library so it builds with the same vcpkg set as the app
+//each sample runs setup untimed, then times body callsPerSample times back to back on a steady clock
+//stdout is muted while a benchmark runs, several hot paths print debug text which would otherwise dominate the timings
+class Harness{
+    public:
+        Harness(const std::string& filter): filter{filter}{}; //only benchmarks whose name contains filter are run, empty runs all
+        void run(const std::string& name, int samples, int callsPerSample, const std::function<void()>& body, const std::function<void()>& setup = nullptr);
+        void printSummary();
+        bool writeJson(const std::string& path); //false if the file couldnt be written
+    private:
+        const int WARMUP_DIVISOR = 10; //samples/WARMUP_DIVISOR untimed samples are run first, at least 1
+
+        std::string filter;
+        std::vector<Result> results;
+};
+
+//stops the compiler discarding a result that is never read, gcc/clang only like the rest of the tree
+template<class T>
+inline void doNotOptimize(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+}
@@ -0,0 +1,196 @@
+#include "bench_harness.h"
+#include "bench_access.h"
+#include "bench_scene.h"
+#include "dmn_checkpoint.h"
+#include "sv_randoms.h"
+#include "vk_mesh.h"
+#include "sv_polyhedronGravity.h"
+#include <iostream>
+
+//micro-benchmarks for the simulation hot paths, usage: BenchmarksLS [output json] [name filter]
+//run from the build folder so resources/ resolves, results are written as json for tracking regressions between releases
+//scenes and images are built from a fixed seed so timings compare like for like
+
+const uint64_t BENCH_SEED = 1;
+const float BENCH_ALTITUDE = 50.0f; //CPU::INITIAL_APPROACH_DISTANCE, the lander hovers here through the estimation phase
+
+static void benchGnc(Bench::Harness& harness, BenchScene& bench){
+    float surface = bench.getSurfaceHeight();
+
+    NavigationStruct nav = NavigationStruct();
+    nav.landingSitePos = glm::vec3(0, 0, surface);
+    nav.landingSiteUp = glm::vec3(0, 0, 1);
+    nav.angularVelocityOfAsteroid = glm::vec3(0.001f, 0.002f, 0.0f);
+    nav.landerPos = glm::vec3(0, 0, surface + BENCH_ALTITUDE);
+    nav.velocityVector = glm::vec3(0, 0, -0.1f);
+    nav.gravityVector = glm::vec3(0, 0, -0.001f);
+    nav.landerTransformMatrix = glm::mat4(1.0f);
+
+    Lander::GNC gnc = Lander::GNC();
+    gnc.init(&bench.mediator, &nav);
+    BenchmarkAccess::calculateVectorsAtTime(gnc, 1000.0f, nav.landingSitePos, nav.landingSiteUp, nav.angularVelocityOfAsteroid);
+    Lander::GNCCheckpoint start = gnc.saveCheckpoint();
+
+    //each call takes one gnc tick off tgo, so every sample starts from the same tgo
+    harness.run("GNC::ZEM_ZEV_Control", 200, 100, [&](){
+        Bench::doNotOptimize(BenchmarkAccess::zemZevControl(gnc, 1.0f, nav.landingSitePos, nav.landingSiteUp, nav.angularVelocityOfAsteroid));
+    }, [&](){gnc.restoreCheckpoint(start);});
+
+    harness.run("GNC::calculateVectorsAtTime", 200, 100, [&](){
+        Bench::doNotOptimize(BenchmarkAccess::calculateVectorsAtTime(gnc, 1000.0f, nav.landingSitePos, nav.landingSiteUp, nav.angularVelocityOfAsteroid));
+    });
+}
+
+static void benchVision(Bench::Harness& harness, BenchScene& bench){
+    NavigationStruct nav = NavigationStruct();
+    nav.altitude = BENCH_ALTITUDE;
+    nav.radiusAtOpticalCenter = bench.getSurfaceHeight();
+
+    Lander::Vision vision = Lander::Vision();
+    vision.init(&bench.mediator, 45.0f, &nav);
+    vision.synchronous = true;
+    Lander::VisionCheckpoint empty = vision.saveCheckpoint();
+
+    //two frames half a degree of asteroid rotation apart, roughly what one imaging interval gives
+    cv::Mat first = bench.renderOptics(BENCH_ALTITUDE, 0.0f);
+    cv::Mat second = bench.renderOptics(BENCH_ALTITUDE, 0.5f);
+
+    //with one image queued detectFeatures doesnt go on to match
+    harness.run("Vision::detectFeatures", 20, 1, [&](){
+        BenchmarkAccess::detectFeatures(vision, first);
+    }, [&](){vision.restoreCheckpoint(empty);});
+
+    //a queue holding both frames, built from two single frame runs so detectFeatures doesnt consume it
+    BenchmarkAccess::detectFeatures(vision, first);
+    Lander::VisionCheckpoint pair = vision.saveCheckpoint();
+    vision.restoreCheckpoint(empty);
+    BenchmarkAccess::detectFeatures(vision, second);
+    Lander::VisionCheckpoint secondOnly = vision.saveCheckpoint();
+    pair.descriptorsQueue.push_back(secondOnly.descriptorsQueue.front());
+    pair.opticsQueue.push_back(secondOnly.opticsQueue.front());
+    pair.keypointsQueue.push_back(secondOnly.keypointsQueue.front());
+    pair.radiusPerImageQueue = {nav.radiusAtOpticalCenter, nav.radiusAtOpticalCenter};
+    pair.altitudePerImageQueue = {nav.altitude, nav.altitude};
+
+    harness.run("Vision::featureMatch", 20, 1, [&](){
+        BenchmarkAccess::featureMatch(vision);
+    }, [&](){vision.restoreCheckpoint(pair);});
+
+    //pure rotation homography H = K*R*K^-1, K matches the intrinsics in findBestAngularVelocityMatchFromDecomp
+    cv::Mat K = (cv::Mat_<double>(3,3) << 1, 0, 256, 0, 1, 256, 0, 0, 1);
+    double angle = 0.5*CV_PI/180.0;
+    cv::Mat R = (cv::Mat_<double>(3,3) << cos(angle), -sin(angle), 0, sin(angle), cos(angle), 0, 0, 0, 1);
+    cv::Mat H = K*R*K.inv();
+
+    harness.run("Vision::findBestAngularVelocityMatchFromDecomp", 100, 1, [&](){
+        Bench::doNotOptimize(BenchmarkAccess::findBestAngularVelocityMatchFromDecomp(vision, H));
+    }, [&](){vision.restoreCheckpoint(pair);});
+}
+
+static void benchPhysics(Bench::Harness& harness, BenchScene& bench){
+    SimCheckpoint start;
+    bench.physics.saveCheckpoint(start);
+
+    //includes each object's timestepBehaviour, so the lander cpu tick is part of this
+    harness.run("WorldPhysics::updateCollisionObjects", 200, 10, [&](){
+        BenchmarkAccess::updateCollisionObjects(bench.physics, bench.physics.FIXED_TIME_STEP);
+    }, [&](){bench.physics.restoreCheckpoint(start);});
+
+    //rays from random points well outside the asteroid towards its centre, so every ray hits its kinematic bvh triangle mesh
+    const int NUM_RAYS = 64;
+    float radius = bench.getSurfaceHeight()*3.0f;
+    Service::RandomStream rng = Service::RandomStream(BENCH_SEED);
+    std::vector<glm::vec3> origins;
+    for(int i = 0; i < NUM_RAYS; i++){
+        glm::vec3 direction = glm::vec3(Service::getRandFloat(rng, -1, 1), Service::getRandFloat(rng, -1, 1), Service::getRandFloat(rng, -1, 1));
+        if(glm::length(direction) < 0.001f)
+            direction = glm::vec3(0, 0, 1);
+        origins.push_back(glm::normalize(direction)*radius);
+    }
+    int ray = 0;
+    harness.run("WorldPhysics::performRayCast", 50, NUM_RAYS, [&](){
+        glm::vec3 from = origins[ray++ % NUM_RAYS];
+        Bench::doNotOptimize(bench.physics.performRayCast(from, glm::normalize(-from)));
+    });
+
+    //same rays as one batch, times the whole batch so compare against NUM_RAYS single casts
+    std::vector<glm::vec3> dirs;
+    for(const glm::vec3& from : origins)
+        dirs.push_back(glm::normalize(-from));
+    std::vector<RayCastHit> hits;
+    bench.physics.performRayCasts(origins, dirs, hits); //first batch builds the bvh
+    harness.run("WorldPhysics::performRayCasts", 50, 1, [&](){
+        bench.physics.performRayCasts(origins, dirs, hits);
+        Bench::doNotOptimize(hits.data());
+    });
+}
+
+//exact polyhedron evaluation is what a cache miss costs, a cached sample is the per substep cost of every lander
+static void benchGravity(Bench::Harness& harness, BenchScene& bench){
+    Mesh* mesh = bench.renderer.getLoadedMesh("asteroid");
+    std::shared_ptr<Service::PolyhedronGravity> model = std::make_shared<Service::PolyhedronGravity>();
+    float scale = bench.scene->getSceneData()->ASTEROID_SCALE;
+    harness.run("PolyhedronGravity::build", 5, 1, [&](){
+        model->build(bench.renderer.get_allVertices(), bench.renderer.get_allIndices(), mesh->indexBase, mesh->indexCount, glm::vec3(scale));
+    });
+
+    glm::dvec3 point = glm::dvec3(0, 0, bench.getSurfaceHeight() + BENCH_ALTITUDE);
+    harness.run("PolyhedronGravity::evaluate", 20, 1, [&](){
+        Bench::doNotOptimize(model->evaluate(point));
+    });
+
+    //a slow descent through the cache, mostly hits with a miss whenever a new cell is entered
+    Service::GravityFieldCache cache = Service::GravityFieldCache(model);
+    glm::dvec3 descent = point;
+    harness.run("GravityFieldCache::sample", 200, 120, [&](){
+        descent.z -= 0.01;
+        Bench::doNotOptimize(cache.sample(descent));
+    }, [&](){descent = point;});
+}
+
+//Vk::Renderer::populateVerticesIndices is loadObjFile plus a mesh push_back, the renderer itself needs a window and device
+static void benchMeshLoading(Bench::Harness& harness){
+    std::unordered_map<Vertex, uint32_t> uniqueVertices;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    harness.run("Renderer::populateVerticesIndices", 10, 1, [&](){
+        Mesh mesh;
+        Vk::loadObjFile("resources/models/asteroidscaled.obj", uniqueVertices, glm::vec3(0,0,1), vertices, indices, mesh); //asteroid entry in MyScene::MODEL_INFOS
+        Bench::doNotOptimize(mesh.indexCount);
+    }, [&](){
+        uniqueVertices.clear();
+        vertices.clear();
+        indices.clear();
+    });
+}
+
+int main(int argc, char* argv[]){
+    std::string outputPath = argc > 1 ? argv[1] : "benchmark_results.json";
+    std::string filter = argc > 2 ? argv[2] : "";
+
+    try{
+        Bench::Harness harness = Bench::Harness(filter);
+        {
+            SceneData sceneData;
+            sceneData.SEED = BENCH_SEED;
+            BenchScene bench = BenchScene(sceneData);
+            benchGnc(harness, bench);
+            benchVision(harness, bench);
+            benchPhysics(harness, bench);
+            benchGravity(harness, bench);
+        }
+        benchMeshLoading(harness);
+
+        harness.printSummary();
+        if(!harness.writeJson(outputPath)){
+            std::cerr << "Could not write " << outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Results written to " << outputPath << "\n";
+    }
+    catch (const std::exception &e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include "bench_scene.h"
+#include "obj_render.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+
+BenchScene::BenchScene(SceneData sceneData){
+    mediator.setPhysicsEngine(&physics);
+    mediator.setRenderEngine(&renderer);
+
+    if(Service::OUTPUT_TEXT){
+        writer.clearOutputFolders();
+        writer.openFiles();
+        mediator.setWriter(&writer);
+    }
+
+    scene = std::make_unique<MyScene>(mediator);
+    mediator.setScene(scene.get());
+    scene->initScene(sceneData);
+    physics.setClockMode(WorldPhysics::ClockMode::SimClock);
+
+    Mesh* asteroidMesh = renderer.getLoadedMesh("asteroid");
+    opticsRaycaster.buildMesh(renderer.get_allVertices(), renderer.get_allIndices(), *asteroidMesh);
+}
+
+BenchScene::~BenchScene(){
+    mediator.renderer_resetScene();
+    mediator.physics_reset();
+    if(Service::OUTPUT_TEXT)
+        writer.closeFiles();
+    scene.reset();
+    mediator.setScene(nullptr);
+}
+
+float BenchScene::getSurfaceHeight(){
+    Mesh* mesh = renderer.getLoadedMesh("asteroid");
+    std::vector<Vertex>& vertices = renderer.get_allVertices();
+    std::vector<uint32_t>& indices = renderer.get_allIndices();
+    float maxZ = 0;
+    for(uint32_t i = mesh->indexBase; i < mesh->indexBase + mesh->indexCount; i++)
+        maxZ = std::max(maxZ, vertices[indices[i]].pos.z);
+    return maxZ*scene->getSceneData()->ASTEROID_SCALE;
+}
+
+cv::Mat BenchScene::renderOptics(float altitude, float asteroidRotation){
+    RenderObject* sceneAsteroid = dynamic_cast<RenderObject*>(&mediator.scene_getFocusableObject("Asteroid"));
+
+    RenderObject asteroid;
+    asteroid.pos = sceneAsteroid->pos;
+    asteroid.scale = sceneAsteroid->scale;
+    asteroid.rot = glm::rotate(glm::mat4{1.0f}, glm::radians(asteroidRotation), glm::vec3(0, 0, 1));
+
+    //optics look down -up, so up along +z looks straight at the surface
+    RenderObject lander;
+    lander.pos = glm::vec3(0, 0, getSurfaceHeight() + altitude);
+    lander.up = glm::vec3(0, 0, 1);
+    lander.forward = glm::vec3(0, 1, 0);
+
+    float fov = 2.5f*scene->getSceneData()->ASTEROID_SCALE; //CPU::BASE_OPTICS_FOV scaled like CPU::init
+    return opticsRaycaster.render(lander, asteroid, glm::vec3(0, 0, -1), fov);
+}
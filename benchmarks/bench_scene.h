@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+#include "mediator.h"
+#include "world_physics.h"
+#include "data_scene.h"
+#include "dmn_myScene.h"
+#include "filewriter.h"
+#include "hl_renderer.h"
+
+//a loaded scene wired up like Headless::Application, but never stepped so benchmarks can call into it directly
+//writes go to bench_output/ so running the benchmarks doesnt clear the apps output folder
+class BenchScene{
+    public:
+        BenchScene(SceneData sceneData);
+        ~BenchScene();
+
+        Mediator mediator = Mediator();
+        WorldPhysics physics = WorldPhysics(mediator);
+        Headless::Renderer renderer;
+        Service::Writer writer = Service::Writer("bench_output/");
+        std::unique_ptr<MyScene> scene;
+
+        //distance from the asteroid centre to its surface along +z, world units
+        float getSurfaceHeight();
+        //optics image from a lander hovering above the +z surface, the asteroid turned by asteroidRotation degrees about z
+        cv::Mat renderOptics(float altitude, float asteroidRotation);
+    private:
+        Headless::OpticsRaycaster opticsRaycaster;
+};
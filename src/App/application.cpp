@@ -2,13 +2,16 @@
 #include "vk_renderer_offscreen.h"
 #include <stdexcept>
 #include <iostream>
+#include "sv_trace.h"
+#include "dmn_replay.h"
 
 
 struct SceneData;
 
 int Application::run(){
     try{
-        
+        Service::Tracer::get().setThreadName("main");
+
         window = windowHandler.initWindow(WIDTH, HEIGHT, "LanderSimulation - Vulkan"); //initialize GLFW window
 
         Vk::OffscreenRenderer renderer = Vk::OffscreenRenderer(window, mediator); //instanciate render engine
@@ -21,9 +24,17 @@ int Application::run(){
         mediator.setRenderEngine(&renderer);
         mediator.setApplication(this);
 
+        //read the whole recording before the output folders are cleared, it may live in them
+        if(!replayFile.empty()){
+            pendingReplay = std::make_unique<ReplayPlayer>();
+            if(!pendingReplay->open(replayFile)){
+                std::cout << "Unable to read replay file " + replayFile + "\n";
+                pendingReplay.reset();
+            }
+        }
+
         //sets up the file system for outputting experiment data
         if(Service::OUTPUT_TEXT){
-            writer = Service::Writer();
             writer.clearOutputFolders();
             writer.openFiles();
             mediator.setWriter(&writer);
@@ -34,6 +45,9 @@ int Application::run(){
 
         //set glfw callbacks for input
         glfwSetWindowUserPointer(window, &uiInput);
+
+        if(pendingReplay)
+            loadScene(pendingReplay->getSceneData()); //the recorded scene, seed already resolved
         
         while (!glfwWindowShouldClose(window)){ //&& appRunning)
             glfwPollEvents(); //keep polling window events
@@ -42,7 +56,8 @@ int Application::run(){
                 worldCamera.updateFixedLookPosition();
             }
             
-            renderer.drawFrame(); //render a frame
+            if(!sceneLoaded || worldPhysics.isRenderDue()) //max throughput time warp skips most frames
+                renderer.drawFrame(); //render a frame
         }
         renderer.cleanup();
     }
@@ -54,9 +69,14 @@ int Application::run(){
 }
 
 void Application::loadScene(SceneData sceneData){
-    scene = std::make_unique<MyScene>(mediator);
-    mediator.setScene(scene.get());
-    scene->initScene(sceneData);
+    std::unique_ptr<MyScene> myScene = std::make_unique<MyScene>(mediator);
+    mediator.setScene(myScene.get());
+    myScene->initScene(sceneData);
+    if(pendingReplay)
+        worldPhysics.startReplay(std::move(pendingReplay));
+    else if(Service::OUTPUT_TEXT && Service::OUTPUT_REPLAY)
+        worldPhysics.startRecording(writer.getOutPath() + "replay.lsrp", *myScene->getSceneData());
+    scene = std::move(myScene);
     worldCamera.init();
     bindWindowCallbacks();
     sceneLoaded = true;
@@ -77,6 +97,22 @@ void Application::resetScene(){
     mediator.setScene(nullptr);
 }
 
+void Application::toggleTraceCapture(){
+    Service::Tracer& tracer = Service::Tracer::get();
+    if(!tracer.isEnabled()){
+        tracer.clear();
+        tracer.setEnabled(true);
+        std::cout << "Trace capture started\n";
+        return;
+    }
+    tracer.setEnabled(false);
+    std::string path = writer.getOutPath() + "trace.json";
+    if(tracer.writeChromeTrace(path))
+        std::cout << "Trace written to " << path << "\n";
+    else
+        std::cout << "Could not write trace to " << path << "\n";
+}
+
 void Application::bindWindowCallbacks(){
     glfwSetKeyCallback(window, key_callback); //key_callback is defined in uiInput, they must be regular functions though, not member functions because glfw is written in C and doesnt understand objects
     glfwSetCursorPosCallback(window, mouse_callback);
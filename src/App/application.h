@@ -13,6 +13,7 @@
 #include "filewriter.h"
 
 class GLFWwindow;
+class ReplayPlayer;
 
 class Application{
     public:
@@ -21,6 +22,8 @@ class Application{
         void endScene();
         void resetScene();
         bool getSceneLoaded(){return sceneLoaded;};
+        void toggleTraceCapture(); //first call starts recording trace zones, second writes them to trace.json in the output folder
+        void setReplayFile(const std::string& path){replayFile = path;}; //plays this recording instead of simulating, call before run
     private:
         Vk::WindowHandler windowHandler;
         GLFWwindow* window; //pointer to the window, freed on cleanup() in VulkanRenderer just now
@@ -35,6 +38,8 @@ class Application{
         std::atomic<bool> sceneLoaded = false;
 
         std::unique_ptr<IScene> scene;
+        std::string replayFile;
+        std::unique_ptr<ReplayPlayer> pendingReplay; //opened in run, handed to physics when its scene is loaded
 
         Service::Writer writer;
 
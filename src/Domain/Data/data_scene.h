@@ -3,6 +3,7 @@
 #define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES //forces GLM to use a version of vec2 and mat4 that have the correct alignment requirements for Vulkan
 #include <glm/glm.hpp>
 #include <glm/gtx/euler_angles.hpp> 
+#include <cstdint>
 
 //scene data, used to configure scene as part of dmn_myScene.cpp
 //allows selection of other scenarios via the menu but this feature was cut to save time
@@ -29,6 +30,27 @@ struct LandingSiteData_2: LandingSiteData{
     }
 };
 
+//scanning lidar carried by every lander, off by default, beams are laid out around the optics boresight (-up)
+//LIDAR_GRID rasters ROWS x COLUMNS across the fov, LIDAR_RINGS is ROWS cones of COLUMNS beams each, like a multi beam altimeter
+enum LidarPattern : int{LIDAR_GRID = 0, LIDAR_RINGS = 1};
+
+struct LidarData{
+    bool ENABLED = false;
+    LidarPattern PATTERN = LIDAR_GRID;
+    int ROWS = 64;
+    int COLUMNS = 64;
+    float FOV_DEGREES = 20.0f; //full angle across the pattern
+    float RATE_HZ = 50.0f; //scans per sim second, 64x64 at 50Hz is ~200k rays per sim second
+    float MAX_RANGE = 5000.0f; //beams with no return closer than this are dropped
+    float RANGE_NOISE = 0.05f; //standard deviation of the gaussian noise on each range, 0 for exact ranges
+    int THREADS = 0; //threads per scan, 0 uses hardware_concurrency
+};
+
+//GRAVITY_POINT_MASS is GRAVITATIONAL_FORCE_MULTIPLIER/sqrt(distance) towards the origin
+//GRAVITY_POLYHEDRON is a constant density polyhedron of the asteroid mesh, its density is picked so gravity at the furthest vertex
+//matches the point mass law there, further out it falls off as 1/r^2 and close in it follows the shape and spin of the asteroid
+enum GravityModel : int{GRAVITY_POINT_MASS = 0, GRAVITY_POLYHEDRON = 1};
+
 struct SceneData{
     bool RANDOMIZE_ROTATION = false;
     float LANDER_START_DISTANCE = 1000.0f;
@@ -39,8 +61,13 @@ struct SceneData{
     float ASTEROID_MIN_ROTATIONAL_VELOCITY = 0.001f;
     float ASTEROID_MAX_ROTATIONAL_VELOCITY = 0.005f;
     float GRAVITATIONAL_FORCE_MULTIPLIER = ASTEROID_SCALE/30.0f;
+    GravityModel GRAVITY_MODEL = GRAVITY_POINT_MASS;
     LandingSiteData landingSite = LandingSiteData_1();
     bool USE_ONLY_ESTIMATE = false;
+    uint64_t SEED = 0; //seeds all scenario randomisation, 0 picks a fresh seed on load, set it to reproduce a run
+    int NUM_LANDERS = 1; //landers sharing the asteroid, each flies its own cpu and optics, only the first writes output files
+    float LANDER_SPACING = 20.0f; //metres between neighbouring landers, they start on a grid perpendicular to the approach axis
+    LidarData lidar = LidarData();
 };
 
 struct ScenarioData_Scenario1: SceneData{
@@ -2,6 +2,8 @@
 #include "mediator.h"
 #include "obj_lander.h"
 #include "obj_landingSite.h"
+#include "world_physics.h"
+#include "sv_trace.h"
 #define GLM_FORCE_RADIANS //makes sure GLM uses radians to avoid confusion
 #define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES //forces GLM to use a version of vec2 and mat4 that have the correct alignment requirements for Vulkan
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE //forces GLM to use depth range of 0 to 1, instead of -1 to 1 as in OpenGL
@@ -12,9 +14,17 @@
 #include <chrono>
 #include <thread>
 #include <iostream>
+#include <limits>
+#include <algorithm>
+#include <cmath>
 
 using namespace Lander;
 
+//timer periods in whole physics substeps
+static int toSubSteps(float seconds){
+    return std::lround(seconds/WorldPhysics::FIXED_TIME_STEP);
+}
+
 void CPU::init(Mediator* mediator, LanderObj* lander){
     p_mediator = mediator;
     p_lander = lander;
@@ -22,6 +32,7 @@ void CPU::init(Mediator* mediator, LanderObj* lander){
     asteroidAngularVelocity = Service::bt2glm(p_landingSite->angularVelocity);
 
     navStruct.useOnlyEstimate = lander->useEstimateOnly; //setting here instead of rewritting heirarchy, crunch time
+    navStruct.landerSlot = lander->slot;
     gnc.init(mediator, &navStruct);
 
     navStruct.asteroidScale = lander->asteroidScale;
@@ -33,16 +44,23 @@ void CPU::init(Mediator* mediator, LanderObj* lander){
     
     cv.init(mediator, IMAGING_TIMER_SECONDS, &navStruct);
 
-    if(Service::OUTPUT_TEXT){
+    lidar.init(mediator, lander->lidarData, &navStruct, lander->lidarRng);
+
+    if(Service::OUTPUT_TEXT && isPrimary()){
         //output fov
         p_mediator->writer_writeToFile("PARAMS", "FOV:" + std::to_string(BASE_OPTICS_FOV*lander->asteroidScale));
         p_mediator->writer_writeToFile("PARAMS", "IMAGE_TIMER:" + std::to_string(IMAGING_TIMER_SECONDS));
         p_mediator->writer_writeToFile("PARAMS", "GNC_TIMER:" + std::to_string(GNC_TIMER_SECONDS));
+        if(lidar.getBeamCount() > 0){
+            p_mediator->writer_writeToFile("PARAMS", "LIDAR_BEAMS:" + std::to_string(lidar.getBeamCount()));
+            p_mediator->writer_writeToFile("PARAMS", "LIDAR_RATE_HZ:" + std::to_string(lander->lidarData.RATE_HZ));
+        }
     }
 }
 
 void CPU::simulationTick(btRigidBody* body, float timeStep){
-    if(Service::OUTPUT_TEXT){ //just added as a quick way to get final LS pos for testing, should be moved ideally
+    TRACE_ZONE("Lander::CPU::simulationTick");
+    if(Service::OUTPUT_TEXT && isPrimary()){ //just added as a quick way to get final LS pos for testing, should be moved ideally
         if(!hasCollided && !gncActive){
             p_mediator->writer_writeToFile("PARAMS", "FINAL SITE POS:" + glm::to_string(p_mediator->scene_getLandingSiteObject()->pos));
             hasCollided = true;
@@ -56,6 +74,8 @@ void CPU::simulationTick(btRigidBody* body, float timeStep){
         std::cout << e.what() << "\n";
     }
 
+    lidar.simulationTick(body, timeStep);
+
     //reaction wheel slew code could be completed (not necessary with near vertical trajectories though)
     if(reactionWheelEnabled){
         //body->setCenterOfMassTransform(Service::glmToBulletT(p_lander->transformMatrix));
@@ -64,18 +84,19 @@ void CPU::simulationTick(btRigidBody* body, float timeStep){
     
     //here we will compute distance to asteroid for calibrating optics fov zoom
     //and then inform offscreen renderer that it can draw the image next cpu cycle
-    if(imagingTimer(timeStep)){
+    int subSteps = std::lround(timeStep/WorldPhysics::FIXED_TIME_STEP); //every physics step is a whole number of substeps
+    if(imagingTimer(subSteps)){
         //first check distance to center point of our camera in world space and store in navstruct to share with gnc and vision
         glm::vec3 opticsCenterWorldPoint = p_mediator->physics_performRayCast(p_lander->pos, -p_lander->up, 100000.0f);
         navStruct.altitude = glm::length(p_lander->pos-opticsCenterWorldPoint);
         navStruct.radiusAtOpticalCenter = glm::length(opticsCenterWorldPoint);
-        p_mediator->renderer_setShouldDrawOffscreen(true); //inform renderer that it can draw offscreen image next cpu cycle
+        p_mediator->renderer_setShouldDrawOffscreen(true, navStruct.landerSlot); //inform renderer that it can draw offscreen image next cpu cycle
     }
 
-    if(gncTimer(timeStep)){
+    if(gncTimer(subSteps)){
         //store real positions
         navStruct.landerPos = p_lander->pos;
-        navStruct.landingSitePos = p_mediator->physics_performRayCast(p_landingSite->pos, -p_landingSite->up, 10.0f); //raycast from landing site past ground (ie -up*10)
+        navStruct.landingSitePos = getLandingSiteSurfacePoint();
         navStruct.landingSiteUp = p_landingSite->up;
 
         /*if(navStruct.useOnlyEstimate){
@@ -95,10 +116,7 @@ void CPU::simulationTick(btRigidBody* body, float timeStep){
 
                 if(Service::OUTPUT_TEXT){
                     //output final estimation data to file
-                    std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-                    p_mediator->writer_writeToFile("EST", "FINAL ESTIMATION");
-                    std::string text = time + ":" + glm::to_string(navStruct.angularVelocityOfAsteroid_Estimate);
-                    p_mediator->writer_writeToFile("EST", text);
+                    p_mediator->writer_writeRecord(Service::TLM_EST_FINAL, p_mediator->physics_getTimeStamp(), navStruct.angularVelocityOfAsteroid_Estimate);
                 }
                 estimateComplete = true;
             }
@@ -120,15 +138,15 @@ void CPU::simulationTick(btRigidBody* body, float timeStep){
 
                 std::cout << glm::to_string(navStruct.angularVelocityOfAsteroid_Estimate) << " estimated angular velocity \n";
                 navStruct.estimationComplete = true;
+                setImaging(false); //vision is done with images, stop asking the renderer for them
 
-                p_mediator->physics_getWorldStats().estimatedAngularVelocity = navStruct.angularVelocityOfAsteroid_Estimate;
+                if(isPrimary()){
+                    p_mediator->physics_getWorldStats().estimatedAngularVelocity = navStruct.angularVelocityOfAsteroid_Estimate;
 
-                if(Service::OUTPUT_TEXT){
-                    //output final estimation data to file
-                    std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-                    p_mediator->writer_writeToFile("EST", "FINAL ESTIMATION");
-                    std::string text = time + ":" + glm::to_string(navStruct.angularVelocityOfAsteroid_Estimate);
-                    p_mediator->writer_writeToFile("EST", text);
+                    if(Service::OUTPUT_TEXT){
+                        //output final estimation data to file
+                        p_mediator->writer_writeRecord(Service::TLM_EST_FINAL, p_mediator->physics_getTimeStamp(), navStruct.angularVelocityOfAsteroid_Estimate);
+                    }
                 }
                 estimateComplete = true;
             }
@@ -155,8 +173,11 @@ void CPU::simulationTick(btRigidBody* body, float timeStep){
         if(nextBoost.torque) //wont be using torque for this because we can use reaction wheels if we have time
             applyTorque(body, nextBoost);
         else{
-            //pass to ui to draw booster firing
-            p_mediator->ui_submitBoostCommand(nextBoost);
+            //pass to ui to draw booster firing, the ui and replay only show the primary lander's boosters
+            if(isPrimary()){
+                p_mediator->ui_submitBoostCommand(nextBoost);
+                p_mediator->physics_recordBoost(nextBoost.vector);
+            }
             applyImpulse(body, nextBoost);
         }
             
@@ -250,23 +271,23 @@ LanderBoostCommand& CPU::popLanderImpulseQueue(){
 }
 
 //this should be renamed, its more than an image timer
-bool CPU::gncTimer(float timeStep){
+bool CPU::gncTimer(int subSteps){
     if(gncActive){
-        gncTime += timeStep;
-        if(gncTime > GNC_TIMER_SECONDS){
-            gncTime = 0;
+        gncSubSteps += subSteps;
+        if(gncSubSteps >= toSubSteps(GNC_TIMER_SECONDS)){
+            gncSubSteps = 0;
             return true;
         }
     }
     return false;
 }
 
-bool CPU::imagingTimer(float timeStep){
+bool CPU::imagingTimer(int subSteps){
     if(imagingActive){
-        imagingTime += timeStep;
-        if(imagingTime > IMAGING_TIMER_SECONDS){
+        imagingSubSteps += subSteps;
+        if(imagingSubSteps >= toSubSteps(IMAGING_TIMER_SECONDS)){
             std::cout << "Image Requested\n";
-            imagingTime = 0;
+            imagingSubSteps = 0;
             return true;
         }
     }
@@ -286,6 +307,7 @@ void CPU::applyImpulse(btRigidBody* rigidbody, LanderBoostCommand boost){
         btVector3 correctedForce = rot * boostDirection;
         //rigidbody->applyCentralForce(correctedForce*force);
         rigidbody->applyCentralImpulse(correctedForce*force);
+        totalDeltaV += force*rigidbody->getInvMass();
     }
     else{
         std::cout << "This is strange, applyImpulse is being triggered when pausing/unpause or changing time\n";
@@ -300,11 +322,95 @@ void CPU::applyTorque(btRigidBody* rigidbody, LanderBoostCommand boost){
     rigidbody->applyTorqueImpulse(correctedForce);
 }
 
+CPUCheckpoint CPU::saveCheckpoint(){
+    CPUCheckpoint checkpoint;
+    checkpoint.useRotationEstimation = useRotationEstimation;
+    checkpoint.estimateComplete = estimateComplete;
+    landerBoostQueueLock.lock();
+    checkpoint.landerBoostQueue = landerBoostQueue;
+    landerBoostQueueLock.unlock();
+    checkpoint.gnc = gnc.saveCheckpoint();
+    checkpoint.navStruct = navStruct;
+    checkpoint.vision = cv.saveCheckpoint();
+    checkpoint.lidar = lidar.saveCheckpoint();
+    checkpoint.hasCollided = hasCollided;
+    checkpoint.lockRotation = lockRotation;
+    checkpoint.reactionWheelEnabled = reactionWheelEnabled;
+    checkpoint.imagingActive = imagingActive;
+    checkpoint.gncActive = gncActive;
+    checkpoint.imagingSubSteps = imagingSubSteps;
+    checkpoint.imgCount = imgCount;
+    checkpoint.gncSubSteps = gncSubSteps;
+    checkpoint.approachDistance = approachDistance;
+    checkpoint.asteroidAngularVelocity = asteroidAngularVelocity;
+    checkpoint.totalDeltaV = totalDeltaV;
+    return checkpoint;
+}
+
+//gnc and vision keep their pointers to navStruct, only its contents are replaced
+void CPU::restoreCheckpoint(const CPUCheckpoint& checkpoint){
+    useRotationEstimation = checkpoint.useRotationEstimation;
+    estimateComplete = checkpoint.estimateComplete;
+    landerBoostQueueLock.lock();
+    landerBoostQueue = checkpoint.landerBoostQueue;
+    landerBoostQueueLock.unlock();
+    gnc.restoreCheckpoint(checkpoint.gnc);
+    navStruct = checkpoint.navStruct;
+    cv.restoreCheckpoint(checkpoint.vision);
+    lidar.restoreCheckpoint(checkpoint.lidar);
+    hasCollided = checkpoint.hasCollided;
+    lockRotation = checkpoint.lockRotation;
+    reactionWheelEnabled = checkpoint.reactionWheelEnabled;
+    imagingActive = checkpoint.imagingActive;
+    gncActive = checkpoint.gncActive;
+    imagingSubSteps = checkpoint.imagingSubSteps;
+    imgCount = checkpoint.imgCount;
+    gncSubSteps = checkpoint.gncSubSteps;
+    approachDistance = checkpoint.approachDistance;
+    asteroidAngularVelocity = checkpoint.asteroidAngularVelocity;
+    totalDeltaV = checkpoint.totalDeltaV;
+}
+
+float CPU::getLandingSiteDistance(){
+    return glm::length(p_lander->pos - getLandingSiteSurfacePoint());
+}
+
+//the surface point this lander steers to, the shared landing site moved by the lander's formation offset
+glm::vec3 CPU::getLandingSiteSurfacePoint(){
+    if(p_lander->siteOffset == glm::vec3(0))
+        return p_mediator->physics_performRayCast(p_landingSite->pos, -p_landingSite->up, 10.0f); //raycast from landing site past ground (ie -up*10)
+
+    //the ground under an offset point can be higher than the site, so cast down from well above it
+    //asteroid only, a lander sitting on the point (or passing over it) mustnt be taken for the ground
+    std::vector<glm::vec3> origins = {p_landingSite->getOffsetPoint(p_lander->siteOffset) + p_landingSite->up*OFFSET_SITE_RAY_LIFT};
+    std::vector<glm::vec3> dirs = {-p_landingSite->up};
+    std::vector<RayCastHit> hits;
+    p_mediator->physics_performRayCasts(origins, dirs, hits, OFFSET_SITE_RAY_LIFT + 10.0f);
+    if(hits.empty() || !hits[0].hit)
+        return p_landingSite->getOffsetPoint(p_lander->siteOffset);
+    return hits[0].point;
+}
+
+//a timer fires on the tick that brings it to its period, so a step of fewer substeps than this wont fire one
+int CPU::getSubStepsUntilNextTimer(){
+    int next = std::numeric_limits<int>::max();
+    if(gncActive)
+        next = std::min(next, toSubSteps(GNC_TIMER_SECONDS) - gncSubSteps);
+    if(imagingActive)
+        next = std::min(next, toSubSteps(IMAGING_TIMER_SECONDS) - imagingSubSteps);
+    return next;
+}
+
 void CPU::setAutopilot(bool b){
     reactionWheelEnabled = b;
     gncActive = b;//maybe need to move later
 }
 
+//turning imaging off also withdraws any request still waiting and drops images nobody will take
 void CPU::setImaging(bool b){
     imagingActive = b;
+    if(!b){
+        p_mediator->renderer_setShouldDrawOffscreen(false, navStruct.landerSlot);
+        p_mediator->renderer_clearCvMatQueue(navStruct.landerSlot);
+    }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <glm/mat4x4.hpp>
 #include "lander_gnc.h"
 #include "lander_vision.h"
+#include "lander_lidar.h"
 #include <deque>
 #include <mutex>
 #include <glm/gtc/quaternion.hpp>
@@ -15,6 +16,23 @@ struct LandingSiteObj;
 class btRigidBody;
 
 namespace Lander{
+    //lander computer state, nav struct, guidance and vision included
+    struct CPUCheckpoint{
+        bool useRotationEstimation, estimateComplete;
+        std::deque<LanderBoostCommand> landerBoostQueue;
+        GNCCheckpoint gnc;
+        NavigationStruct navStruct;
+        VisionCheckpoint vision;
+        LidarCheckpoint lidar;
+        bool hasCollided, lockRotation, reactionWheelEnabled, imagingActive, gncActive;
+        int imagingSubSteps;
+        int imgCount;
+        int gncSubSteps;
+        float approachDistance;
+        glm::vec3 asteroidAngularVelocity;
+        float totalDeltaV;
+    };
+
     //holds lander impulse request --should be in obj_lander but i'd need to modify flow a lot
     class CPU{
     private:
@@ -29,9 +47,12 @@ namespace Lander{
 
         Vision cv = Vision();
 
+        Lidar lidar = Lidar();
+
         const float BASE_OPTICS_FOV = 2.5f;
 
         const float INITIAL_APPROACH_DISTANCE = 50.0f;
+        const float OFFSET_SITE_RAY_LIFT = 100.0f; //metres above an offset landing site point its ground ray starts
         
         const float BOOST_STRENGTH = 1.0f;
         const float LANDER_BOOST_CAP = 5.0f; //physical limit for an individual boost, regardless of requested boost 
@@ -46,19 +67,20 @@ namespace Lander{
         
         bool imagingActive = true;
         bool gncActive = true;
-        float imagingTime = 0.0f;
+        int imagingSubSteps = 0; //timers count whole physics substeps, float seconds drift and the step limiter couldnt know which substep fires
         int imgCount = 0; //only used for resetting test plane every first image
-        float gncTime = 0.0f;
+        int gncSubSteps = 0;
         float approachDistance = 0.0f;
         glm::vec3 asteroidAngularVelocity;
+        float totalDeltaV = 0.0f; //summed speed change from every translation boost applied, m/s
 
         Mediator* p_mediator;
         LanderObj* p_lander;
         LandingSiteObj* p_landingSite;
         
         //contol timers
-        bool imagingTimer(float timeStep);
-        bool gncTimer(float timeStep);
+        bool imagingTimer(int subSteps);
+        bool gncTimer(int subSteps);
 
         //boost methods
         void applyImpulse(btRigidBody* rigidbody, LanderBoostCommand boost);
@@ -71,6 +93,8 @@ namespace Lander{
         void showEstimationStats();
         glm::vec3 getFinalEstimatedAngularVelocity();
         NavigationStruct* getNavStruct(){return &navStruct;};
+        glm::vec3 getLandingSiteSurfacePoint();
+        bool isPrimary(){return navStruct.landerSlot == 0;}; //secondary landers dont write output files or drive the ui
         
     public:
         void toggleRotationEstimation(){useRotationEstimation = !useRotationEstimation;};
@@ -78,6 +102,19 @@ namespace Lander{
         void simulationTick(btRigidBody* body, float timeStep);
         void setAutopilot(bool b);
         void setImaging(bool b);
+        void setSynchronousVision(bool b){cv.synchronous = b;};
+        bool isDescending(){return gnc.isDescending();};
+        int getSubStepsUntilNextTimer(); //substeps up to and including the one gnc or imaging next fires on, int max if neither is active
+        int getSubStepsUntilNextScan(){return lidar.getSubStepsUntilNextScan();}; //same for the lidar
+
+        //landing outcome metrics, read by headless runs when the lander touches down
+        float getTotalDeltaV(){return totalDeltaV;};
+        float getLandingSiteDistance(); //lander to the surface point under its landing site, the same point gnc steers to
+        bool hasSpinEstimate(){return navStruct.useOnlyEstimate && navStruct.estimationComplete;};
+        float getSpinEstimateError(){return glm::length(navStruct.angularVelocityOfAsteroid_Estimate - navStruct.angularVelocityOfAsteroid);};
+
+        CPUCheckpoint saveCheckpoint();
+        void restoreCheckpoint(const CPUCheckpoint& checkpoint);
         void addImpulseToLanderQueue(float duration, float x, float y, float z, bool torque);
     };
 }
\ No newline at end of file
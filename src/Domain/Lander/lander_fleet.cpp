@@ -0,0 +1,93 @@
+#include "lander_fleet.h"
+#include "obj_lander.h"
+#include "obj_collisionRender.h"
+#include <glm/gtx/fast_square_root.hpp>
+
+using namespace Lander;
+
+void Fleet::clear(){
+    landers.clear();
+    bodies.clear();
+    gravity.clear();
+    gravityMagnitude.clear();
+    gravityField.reset();
+    p_asteroid = nullptr;
+}
+
+void Fleet::setGravityField(std::shared_ptr<Service::GravityFieldCache> field, CollisionRenderObj* asteroid){
+    gravityField = field;
+    p_asteroid = asteroid;
+}
+
+int Fleet::add(LanderObj* lander){
+    landers.push_back(lander);
+    bodies.push_back(nullptr);
+    gravity.push_back(btVector3(0,0,0));
+    gravityMagnitude.push_back(0.0f);
+    return landers.size() - 1;
+}
+
+//the slot is also stored as the body's user index, so contacts can be traced back to a lander without a search
+void Fleet::bindBodies(){
+    for(int i = 0; i < landers.size(); i++){
+        bodies[i] = btRigidBody::upcast(landers[i]->p_btCollisionObject);
+        bodies[i]->setUserIndex(i);
+    }
+}
+
+int Fleet::findSlot(const btCollisionObject* object){
+    int slot = object->getUserIndex();
+    if(slot < 0 || slot >= bodies.size() || bodies[slot] != object)
+        return -1;
+    return slot;
+}
+
+bool Fleet::anyCollided(){
+    for(LanderObj* lander : landers){
+        if(lander->collided)
+            return true;
+    }
+    return false;
+}
+
+bool Fleet::allCollided(){
+    for(LanderObj* lander : landers){
+        if(!lander->collided)
+            return false;
+    }
+    return true;
+}
+
+void Fleet::updateGravity(){
+    for(int i = 0; i < bodies.size(); i++){
+        const btVector3& position = bodies[i]->getWorldTransform().getOrigin();
+        if(gravityField){
+            gravity[i] = gravityAt(position);
+            gravityMagnitude[i] = gravity[i].length();
+        }
+        else{
+            gravityMagnitude[i] = pointMassMagnitudeAt(position);
+            gravity[i] = -position.normalized()*gravityMagnitude[i];
+        }
+    }
+}
+
+float Fleet::pointMassMagnitudeAt(const btVector3& position){
+    return gravityMultiplier*glm::fastInverseSqrt(position.length());
+}
+
+float Fleet::gravityMagnitudeAt(const btVector3& position){
+    if(gravityField)
+        return gravityAt(position).length();
+    return pointMassMagnitudeAt(position);
+}
+
+btVector3 Fleet::gravityAt(const btVector3& position){
+    if(gravityField){
+        const btTransform& transform = p_asteroid->p_btCollisionObject->getWorldTransform();
+        btVector3 local = transform.invXform(position);
+        glm::dvec3 g = gravityField->sample(glm::dvec3(local.x(), local.y(), local.z()));
+        return transform.getBasis()*btVector3(g.x, g.y, g.z);
+    }
+    return -position.normalized()*pointMassMagnitudeAt(position);
+}
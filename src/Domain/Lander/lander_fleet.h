@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <bullet/btBulletDynamicsCommon.h>
+#include "sv_polyhedronGravity.h"
+
+struct LanderObj;
+struct CollisionRenderObj;
+
+namespace Lander{
+
+    //every lander in the scene, indexed by slot, slot 0 is the primary lander the ui, camera and output files follow
+    //per substep state is kept in parallel arrays so the whole fleet's gravity is one pass over contiguous memory
+    //each lander's cpu, gnc and vision stay in its LanderObj and run once per substep from its timestepBehaviour
+    class Fleet{
+    public:
+        void clear();
+        int add(LanderObj* lander); //returns the lander's slot
+        void bindBodies(); //call once the landers' rigid bodies have been created
+        void setGravityMultiplier(double multiplier){gravityMultiplier = multiplier;};
+        //polyhedron gravity, sampled in the asteroid's body frame so the field turns with it, the point mass law is used if unset
+        void setGravityField(std::shared_ptr<Service::GravityFieldCache> field, CollisionRenderObj* asteroid);
+
+        int size(){return landers.size();};
+        LanderObj* get(int slot){return landers.at(slot);};
+        btRigidBody* getBody(int slot){return bodies[slot];};
+        int findSlot(const btCollisionObject* object); //-1 if object isnt one of the landers
+        bool anyCollided();
+        bool allCollided();
+
+        void updateGravity(); //once per substep, before any lander's timestepBehaviour
+        const btVector3& getGravity(int slot){return gravity[slot];};
+        float getGravityMagnitude(int slot){return gravityMagnitude[slot];};
+
+        float gravityMagnitudeAt(const btVector3& position);
+        btVector3 gravityAt(const btVector3& position);
+
+    private:
+        double gravityMultiplier = 0;
+        std::shared_ptr<Service::GravityFieldCache> gravityField;
+        CollisionRenderObj* p_asteroid = nullptr;
+
+        //asteroid is always at origin so dir of gravity is aways towards 0
+        float pointMassMagnitudeAt(const btVector3& position);
+
+        std::vector<LanderObj*> landers;
+        std::vector<btRigidBody*> bodies;
+        std::vector<btVector3> gravity;
+        std::vector<float> gravityMagnitude;
+    };
+}
@@ -20,6 +20,21 @@ void GNC::init(Mediator* mediator, NavigationStruct* gncVars){
     p_navStruct = gncVars;
 }
 
+GNCCheckpoint GNC::saveCheckpoint(){
+    return GNCCheckpoint{tf, t, tgo, shouldDescend, projectedLandingSitePos, projectedVelocityAtTf, projectedLandingSiteUp, rotationMatrixAtTf};
+}
+
+void GNC::restoreCheckpoint(const GNCCheckpoint& checkpoint){
+    tf = checkpoint.tf;
+    t = checkpoint.t;
+    tgo = checkpoint.tgo;
+    shouldDescend = checkpoint.shouldDescend;
+    projectedLandingSitePos = checkpoint.projectedLandingSitePos;
+    projectedVelocityAtTf = checkpoint.projectedVelocityAtTf;
+    projectedLandingSiteUp = checkpoint.projectedLandingSiteUp;
+    rotationMatrixAtTf = checkpoint.rotationMatrixAtTf;
+}
+
 glm::vec3 GNC::getThrustVector(float timeStep){
     glm::vec3 thrustVector{0};
 
@@ -41,14 +56,11 @@ glm::vec3 GNC::getThrustVector(float timeStep){
     else{
         thrustVector = ZEM_ZEV_Control(timeStep, sitePos, siteUp, angularVelocity);
 
-        if(Service::OUTPUT_TEXT){
+        if(Service::OUTPUT_TEXT && p_navStruct->landerSlot == 0){
             //output nav data to file
-            std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-            std::string text = time + ":" + glm::to_string(p_navStruct->landerPos);
-            p_mediator->writer_writeToFile("NAV", text);
-
-            text = time + ":" + glm::to_string(thrustVector);
-            p_mediator->writer_writeToFile("THRUST", text);
+            double time = p_mediator->physics_getTimeStamp();
+            p_mediator->writer_writeRecord(Service::TLM_NAV, time, p_navStruct->landerPos);
+            p_mediator->writer_writeRecord(Service::TLM_THRUST, time, thrustVector);
         }
     }
 
@@ -95,13 +107,10 @@ void GNC::calculateVectorsAtTime(float time, glm::vec3 sitePos, glm::vec3 siteUp
         glm::vec3 projectedLandingSitePosPlus1 = rotationMatrixAtTfPlus1 * glm::vec4(sitePos, 1.0f);
         projectedVelocityAtTf = projectedLandingSitePosPlus1 - projectedLandingSitePos; //there's a cleaner way to get linear vel of point in 3d from angular velocity, this is a workaround
 
-        if(Service::OUTPUT_TEXT){
+        if(Service::OUTPUT_TEXT && p_navStruct->landerSlot == 0){
             //output nav data to file
-            if(!shouldDescend){ 
-                std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-                std::string text = time + ":projectedposition:" + glm::to_string(projectedLandingSitePos);
-                p_mediator->writer_writeToFile("PRE", text);
-            }
+            if(!shouldDescend)
+                p_mediator->writer_writeRecord(Service::TLM_PRE_PROJECTED, p_mediator->physics_getTimeStamp(), projectedLandingSitePos);
         }
 
         if(p_navStruct->useOnlyEstimate)
@@ -140,17 +149,12 @@ glm::vec3 GNC::ZEM_ZEV_Control(float timeStep, glm::vec3 sitePos, glm::vec3 site
     glm::vec3 zev = getZEV(projectedVelocityAtTf, p_navStruct->velocityVector);
     glm::vec3 acc = getZEMZEVAccel(zem,zev);
 
-    if(Service::OUTPUT_TEXT){
+    if(Service::OUTPUT_TEXT && p_navStruct->landerSlot == 0){
         //output nav data to file
-        std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-        std::string text = time + ":ZEM:" + glm::to_string(zem);
-        p_mediator->writer_writeToFile("GNC", text);
-
-        text = time + ":ZEV:" + glm::to_string(zev);
-        p_mediator->writer_writeToFile("GNC", text);
-
-        text = time + ":ZEMZEV_Accel:" + glm::to_string(acc);
-        p_mediator->writer_writeToFile("GNC", text);
+        double time = p_mediator->physics_getTimeStamp();
+        p_mediator->writer_writeRecord(Service::TLM_GNC_ZEM, time, zem);
+        p_mediator->writer_writeRecord(Service::TLM_GNC_ZEV, time, zev);
+        p_mediator->writer_writeRecord(Service::TLM_GNC_ACCEL, time, acc);
     }
 
     //we correct the world coordinate vector generated into a local thrust vector for the lander
@@ -194,7 +198,7 @@ void GNC::updateTgo(float timeStep){
         tgo = TF_TIME;
         tf = TF_TIME;
         t = 0.0f;
-        p_mediator->physics_landerCollided(); //we are just marking as collided to stop simulation and output final positions (hack due to time constraints for testing)
+        p_mediator->physics_landerCollided(p_navStruct->landerSlot); //we are just marking as collided to stop simulation and output final positions (hack due to time constraints for testing)
     }
     std::cout << tgo  << " time-to-go\n";
 }
@@ -5,10 +5,22 @@
 #include "lander_navstruct.h"
 
 class Mediator;
+struct BenchmarkAccess; //benchmarks/ times the private guidance routines directly
 
 namespace Lander{
 
+    //guidance state carried between gnc ticks
+    struct GNCCheckpoint{
+        float tf, t, tgo;
+        bool shouldDescend;
+        glm::vec3 projectedLandingSitePos;
+        glm::vec3 projectedVelocityAtTf;
+        glm::vec3 projectedLandingSiteUp;
+        glm::mat4 rotationMatrixAtTf;
+    };
+
     class GNC{
+        friend struct ::BenchmarkAccess;
     private:
 
         NavigationStruct* p_navStruct;
@@ -53,5 +65,9 @@ namespace Lander{
         GNC(){};
         void init(Mediator* mediator, NavigationStruct* gncVars);
         glm::vec3 getThrustVector(float timeStep);
+        bool isDescending(){return shouldDescend;};
+
+        GNCCheckpoint saveCheckpoint();
+        void restoreCheckpoint(const GNCCheckpoint& checkpoint);
     };
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "lander_lidar.h"
+#include "mediator.h"
+#include "world_physics.h"
+#include "sv_trace.h"
+#include "sv_workerPool.h"
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+using namespace Lander;
+
+void Lidar::init(Mediator* mediator, const LidarData& lidarData, NavigationStruct* navStruct, Service::RandomStream noiseRng){
+    p_mediator = mediator;
+    config = lidarData;
+    p_navStruct = navStruct;
+    rng = noiseRng;
+    subSteps = 0;
+    scanCount = 0;
+    scanPending = false;
+    buildBeams();
+}
+
+void Lidar::buildBeams(){
+    beams.clear();
+    if(!config.ENABLED)
+        return;
+    int rows = std::max(1, config.ROWS);
+    int columns = std::max(1, config.COLUMNS);
+    float halfFov = glm::radians(config.FOV_DEGREES)*0.5f;
+    beams.reserve(rows*columns);
+    for(int r = 0; r < rows; r++){
+        for(int c = 0; c < columns; c++){
+            if(config.PATTERN == LIDAR_RINGS){
+                //ring r is a cone at (r+1)/rows of the half fov, beams evenly spaced around it
+                float cone = halfFov*(r + 1)/rows;
+                float azimuth = glm::two_pi<float>()*c/columns;
+                beams.push_back(glm::vec3(sin(cone)*cos(azimuth), sin(cone)*sin(azimuth), -cos(cone)));
+            }
+            else{
+                //beam centres of a rows x columns raster, evenly spaced in angle across the fov
+                float angleX = ((c + 0.5f)/columns - 0.5f)*2.0f*halfFov;
+                float angleY = ((r + 0.5f)/rows - 0.5f)*2.0f*halfFov;
+                beams.push_back(glm::normalize(glm::vec3(tan(angleX), tan(angleY), -1.0f)));
+            }
+        }
+    }
+}
+
+//worked out from the scan number rather than summed, so the period's fraction of a substep never drifts
+int64_t Lidar::getScanSubStep(int64_t scan){
+    return std::max<int64_t>(scan, std::ceil(scan/((double)config.RATE_HZ*WorldPhysics::FIXED_TIME_STEP) - 1e-9));
+}
+
+int Lidar::getSubStepsUntilNextScan(){
+    if(beams.empty() || config.RATE_HZ <= 0)
+        return std::numeric_limits<int>::max();
+    return std::max<int64_t>(1, getScanSubStep(scanCount + 1) - subSteps);
+}
+
+void Lidar::simulationTick(btRigidBody* body, float timeStep){
+    if(beams.empty() || config.RATE_HZ <= 0)
+        return;
+    subSteps += std::lround(timeStep/WorldPhysics::FIXED_TIME_STEP);
+    if(subSteps < getScanSubStep(scanCount + 1))
+        return;
+    //steps are cut to end on a scan, so only a wall clock frame can pass more than one
+    //the ones it passed would all be taken from this pose, so they are counted but only the latest is cast
+    while(getScanSubStep(scanCount + 1) <= subSteps)
+        scanCount++;
+    publish(); //the scan started one period ago
+    startScan(body);
+}
+
+void Lidar::finishInFlight(){
+    if(!inFlight.valid())
+        return;
+    TRACE_ZONE("Lander::Lidar::finishInFlight");
+    pending = inFlight.get(); //only blocks if the scan is still running, eg at uncapped sim speed
+    scanPending = true;
+}
+
+void Lidar::publish(){
+    finishInFlight();
+    if(!scanPending)
+        return;
+    rng = pending.rng;
+    p_navStruct->lidarPoints = std::move(pending.points);
+    p_navStruct->lidarScanTime = pending.time;
+    pending.points.clear();
+    scanPending = false;
+}
+
+void Lidar::startScan(btRigidBody* body){
+    TRACE_ZONE("Lander::Lidar::startScan");
+    AsteroidRayFrame frame = p_mediator->physics_getAsteroidRayFrame();
+    if(!frame.bvh)
+        return;
+
+    const btTransform& transform = body->getWorldTransform();
+    const btMatrix3x3& basis = transform.getBasis();
+    glm::mat3 bodyToWorld = glm::mat3(Service::bt2glm(basis.getColumn(0)), Service::bt2glm(basis.getColumn(1)), Service::bt2glm(basis.getColumn(2)));
+    std::vector<glm::vec3> origins(beams.size(), Service::bt2glm(transform.getOrigin()));
+    std::vector<glm::vec3> dirs(beams.size());
+    for(size_t i = 0; i < beams.size(); i++)
+        dirs[i] = bodyToWorld*beams[i];
+
+    //everything the scan needs is copied in, the lander can move on or be destroyed while it runs
+    LidarScan scan;
+    scan.time = p_mediator->physics_getTimeStamp();
+    scan.rng = rng;
+    inFlight = Service::WorkerPool::shared().submit([frame, origins = std::move(origins), dirs = std::move(dirs), beams = beams, scan = std::move(scan), config = config]() mutable{
+        TRACE_ZONE("Lander::Lidar::scan");
+        std::vector<RayCastHit> hits;
+        frame.cast(origins, dirs, hits, config.MAX_RANGE, config.THREADS);
+        scan.points.reserve(hits.size());
+        for(size_t i = 0; i < hits.size(); i++){
+            if(!hits[i].hit)
+                continue;
+            float range = hits[i].fraction*config.MAX_RANGE;
+            if(config.RANGE_NOISE > 0){
+                //box muller, one draw per return in beam order
+                float u1 = std::max(scan.rng.nextFloat(), 1e-7f);
+                float u2 = scan.rng.nextFloat();
+                range += config.RANGE_NOISE*sqrt(-2.0f*log(u1))*cos(glm::two_pi<float>()*u2);
+            }
+            scan.points.push_back(beams[i]*std::max(range, 0.0f));
+        }
+        return scan;
+    });
+}
+
+LidarCheckpoint Lidar::saveCheckpoint(){
+    finishInFlight();
+    return LidarCheckpoint{subSteps, scanCount, scanPending, pending, rng};
+}
+
+void Lidar::restoreCheckpoint(const LidarCheckpoint& checkpoint){
+    if(inFlight.valid())
+        inFlight.wait(); //belongs to the timeline being replaced
+    inFlight = std::future<LidarScan>();
+    subSteps = checkpoint.subSteps;
+    scanCount = checkpoint.scanCount;
+    scanPending = checkpoint.scanPending;
+    pending = checkpoint.pending;
+    rng = checkpoint.rng;
+}
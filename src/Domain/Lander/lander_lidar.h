@@ -0,0 +1,63 @@
+#pragma once
+#include "data_scene.h"
+#include <vector>
+#include <future>
+#include <cstdint>
+#include "lander_navstruct.h"
+#include "sv_randoms.h"
+
+class Mediator;
+class btRigidBody;
+
+namespace Lander{
+
+    //one scan, points are in the lander body frame at the substep the scan was taken, beams with no return are left out
+    struct LidarScan{
+        double time = 0;
+        std::vector<glm::vec3> points;
+        Service::RandomStream rng; //noise stream after this scan, handed back so the draws dont depend on which thread ran it
+    };
+
+    //an in flight scan is waited for and saved as finished, so a restore publishes the same points
+    struct LidarCheckpoint{
+        int64_t subSteps, scanCount;
+        bool scanPending;
+        LidarScan pending;
+        Service::RandomStream rng;
+    };
+
+    //scanning range sensor, fires every 1/RATE_HZ sim seconds from the lander's centre, each scan on the substep its time falls in
+    //each scan snapshots the asteroid pose and is cast on Service::WorkerPool while physics keeps stepping
+    //the scan is published to the nav struct when the next one fires, so readings are one period old and never depend on thread timing
+    //a scan is started in the pre tick from the pose at the start of its substep, far field and adaptive steps end the substep before
+    //so that substep is always stepped alone and a scan sees the same pose and timestamp whatever step size the clearance picked
+    class Lidar{
+        public:
+            void init(Mediator* mediator, const LidarData& lidarData, NavigationStruct* navStruct, Service::RandomStream noiseRng);
+            void simulationTick(btRigidBody* body, float timeStep);
+            int getBeamCount(){return beams.size();};
+            int getSubStepsUntilNextScan(); //int max if the lidar is off
+
+            LidarCheckpoint saveCheckpoint();
+            void restoreCheckpoint(const LidarCheckpoint& checkpoint);
+        private:
+            LidarData config;
+            Mediator* p_mediator;
+            NavigationStruct* p_navStruct;
+
+            std::vector<glm::vec3> beams; //unit directions in the lander body frame, -z is the optics boresight
+            int64_t subSteps = 0; //stepped since init, scan n is due on substep ceil(n/(RATE_HZ*FIXED_TIME_STEP)) so the rate holds on average
+            int64_t scanCount = 0;
+            Service::RandomStream rng;
+
+            std::future<LidarScan> inFlight;
+            LidarScan pending;
+            bool scanPending = false;
+
+            void buildBeams();
+            int64_t getScanSubStep(int64_t scan);
+            void finishInFlight();
+            void publish();
+            void startScan(btRigidBody* body);
+    };
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <vector>
 
 //navigation structure packet for the lander
 struct NavigationStruct{
@@ -21,6 +22,9 @@ struct NavigationStruct{
     int asteroidScale;
     glm::vec3 landerPos;
     bool useOnlyEstimate = false;
+    int landerSlot = 0; //slot in the scene's lander fleet, only slot 0 writes output files and drives the ui
+    std::vector<glm::vec3> lidarPoints; //latest lidar scan, lander body frame, empty until the first scan is published
+    double lidarScanTime = -1; //sim time lidarPoints were measured
 };
 
 //boost structure packet generated by GNC
@@ -11,6 +11,7 @@
 #include <glm/gtx/string_cast.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "sv_randoms.h"
+#include "sv_trace.h"
 #include <bits/stdc++.h>
 
 using namespace Lander;
@@ -25,35 +26,47 @@ void Vision::init(Mediator* mediator, float imageTimer, NavigationStruct* gncVar
 }
 
 void Vision::simulationTick(){
-    if(active){
-        if(!p_mediator->renderer_cvMatQueueEmpty()){
-            std::unique_lock<std::mutex> lock(processingLock, std::try_to_lock); //try to acquire processingLock
+    int landerSlot = p_navStruct->landerSlot;
+    if(!active){
+        //estimation is finished or was never used, nothing will take these so dont let them pile up
+        if(!p_mediator->renderer_cvMatQueueEmpty(landerSlot))
+            p_mediator->renderer_clearCvMatQueue(landerSlot);
+        return;
+    }
+
+    //each lander has its own image queue in the renderer, so one that stops taking images never holds up the rest
+    if(!p_mediator->renderer_cvMatQueueEmpty(landerSlot)){
+        std::unique_lock<std::mutex> lock(processingLock, std::try_to_lock); //try to acquire processingLock
 
-            if(!lock.owns_lock())  //if we dont have the lock then return error
-                throw std::runtime_error("Lock Failed, processing is taking longer than submission");
+        if(!lock.owns_lock())  //if we dont have the lock then return error
+            throw std::runtime_error("Lock Failed, processing is taking longer than submission");
 
-            cv::Mat nextImage = p_mediator->renderer_frontCvMatQueue(); //image data is not copied, just the wrapper to memory is copied
-            p_mediator->renderer_popCvMatQueue(); //we can actually pop the queue as well just now safely
+        cv::Mat nextImage = p_mediator->renderer_frontCvMatQueue(landerSlot); //image data is not copied, just the wrapper to memory is copied
+        p_mediator->renderer_popCvMatQueue(landerSlot); //we can actually pop the queue as well just now safely
 
-            radiusPerImageQueue.emplace_back(p_navStruct->radiusAtOpticalCenter); //storing radius at time image is taken
-            altitudePerImageQueue.emplace_back(p_navStruct->altitude); //storing alt at time image is taken
+        radiusPerImageQueue.emplace_back(p_navStruct->radiusAtOpticalCenter); //storing radius at time image is taken
+        altitudePerImageQueue.emplace_back(p_navStruct->altitude); //storing alt at time image is taken
 
-            std::thread thread(&Lander::Vision::detectFeatures, this, nextImage); //we run the conversions in a seperate thread, solves stuttering during processing
-            thread.detach();   
+        if(synchronous){
+            detectFeatures(nextImage);
+            return;
         }
+        std::thread thread(&Lander::Vision::detectFeatures, this, nextImage); //we run the conversions in a seperate thread, solves stuttering during processing
+        thread.detach();   
     }
 }
 
 //some code adapted from OpenCV documentation https://docs.opencv.org/4.x/d9/dab/tutorial_homography.html
 void Vision::detectFeatures(cv::Mat optics){
+    TRACE_ZONE("Vision::detectFeatures");
 
     opticsQueue.push_back(optics.clone()); //copy image from gpu
 
     //preprocessing
     opticsQueue.back().convertTo(opticsQueue.back(), -1, 2.0, 0.0f);
 
-    if(Service::OUTPUT_OPTICS){
-        cv::imwrite(Service::OPTICS_PATH + "optics" + std::to_string(opticCount) + ".jpg", opticsQueue.back());
+    if(Service::OUTPUT_OPTICS && p_navStruct->landerSlot == 0){
+        p_mediator->writer_writeImage(p_mediator->writer_getOpticsPath() + "optics" + std::to_string(opticCount), opticsQueue.back()); //shared, opticsQueue only reads it from here on
         opticCount++;
     }
 
@@ -84,10 +97,11 @@ void Vision::detectFeatures(cv::Mat optics){
     cv::drawKeypoints(opticsQueue.back(), kp, kpimage);
     
     //passing back to renderer to copy image to feature detection queue for drawing in ui_handler 
-    p_mediator->renderer_assignMatToDetectionView(kpimage);
+    if(p_navStruct->landerSlot == 0) //ui only shows the primary lander's optics
+        p_mediator->renderer_assignMatToDetectionView(kpimage);
 
-    if(Service::OUTPUT_OPTICS){
-        cv::imwrite(Service::OPTICS_FEATURE_PATH + "feature" + std::to_string(featureCount) + ".jpg", kpimage);
+    if(Service::OUTPUT_OPTICS && p_navStruct->landerSlot == 0){
+        p_mediator->writer_writeImage(p_mediator->writer_getOpticsFeaturePath() + "feature" + std::to_string(featureCount), std::move(kpimage));
         featureCount++;
     }
 
@@ -123,10 +137,11 @@ void Vision::featureMatch(){
                     cv::Scalar::all(-1), cv::Scalar::all(-1), std::vector<char>(), cv::DrawMatchesFlags::DEFAULT);//, cv::DrawMatchesFlags::DEFAULT);
 
         //passing back to renderer to draw the image to ui
-        p_mediator->renderer_assignMatToMatchingView(matchedImage); //must be a seperate mapped imageview and image
+        if(p_navStruct->landerSlot == 0)
+            p_mediator->renderer_assignMatToMatchingView(matchedImage); //must be a seperate mapped imageview and image
 
-        if(Service::OUTPUT_OPTICS){
-            cv::imwrite(Service::OPTICS_MATCH_PATH + "match" + std::to_string(matchCount) + ".jpg", matchedImage);
+        if(Service::OUTPUT_OPTICS && p_navStruct->landerSlot == 0){
+            p_mediator->writer_writeImage(p_mediator->writer_getOpticsMatchPath() + "match" + std::to_string(matchCount), std::move(matchedImage));
             matchCount++;
         }
 
@@ -249,29 +264,15 @@ glm::vec3 Vision::findBestAngularVelocityMatchFromDecomp(cv::Mat H){
             if(axis == 1)
                 angularVelocityEstimation[1] = -angularVelocityEstimation[1]; //if y axis we need to invert it to correct for world orientation
             
-            if(Service::OUTPUT_TEXT){
+            if(Service::OUTPUT_TEXT && p_navStruct->landerSlot == 0){
                 if(possibleSolutions.size() == 0){ //we only take first viable estimate, usually the right one, this can be improved but won't effect final estimation if it's the wrong direction
-                    //output single estimation data to file
-                    std::string time = std::to_string(p_mediator->physics_getTimeStamp());
-                    std::string prepend = "match" + std::to_string(matchCount-1) + ":" + time;
-                    std::string text = prepend + ":estimation:" + glm::to_string(angularVelocityEstimation);
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":pixelsmoved:" + std::to_string(pixelsMoved);
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":unitsmoved:" + std::to_string(unitsMoved);
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":radiusimg1:" + std::to_string(radiusPerImageQueue.at(0));
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":radiusimg2:" + std::to_string(radiusPerImageQueue.at(1));
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":avgradius:" + std::to_string(avgRadius);
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":altitudeimg1:" + std::to_string(altitudePerImageQueue.at(0));
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":altitudeimg2:" + std::to_string(altitudePerImageQueue.at(1));
-                    p_mediator->writer_writeToFile("EST", text);
-                    text = prepend + ":avgaltitude:" + std::to_string(avgAltitude);
-                    p_mediator->writer_writeToFile("EST", text);
+                    //output single estimation data to file, columns are listed in TELEMETRY_CHANNELS
+                    p_mediator->writer_writeRecord(Service::TelemetryRecord{p_mediator->physics_getTimeStamp(), Service::TLM_EST_MATCH, {
+                        static_cast<float>(matchCount-1),
+                        angularVelocityEstimation.x, angularVelocityEstimation.y, angularVelocityEstimation.z,
+                        pixelsMoved, unitsMoved,
+                        radiusPerImageQueue.at(0), radiusPerImageQueue.at(1), avgRadius,
+                        altitudePerImageQueue.at(0), altitudePerImageQueue.at(1), avgAltitude}});
                 }
             }
         }
@@ -304,4 +305,39 @@ glm::vec3 Vision::findBestAngularVelocityMatchFromDecomp(cv::Mat H){
 //compares distance of matches, for use in vector sorting of matches
 bool Vision::compareDistance(cv::DMatch d1, cv::DMatch d2){
     return (d1.distance <= d2.distance);
-}
\ No newline at end of file
+}
+VisionCheckpoint Vision::saveCheckpoint(){
+    std::scoped_lock<std::mutex> lock(processingLock);
+    VisionCheckpoint checkpoint;
+    checkpoint.opticCount = opticCount;
+    checkpoint.matchCount = matchCount;
+    checkpoint.featureCount = featureCount;
+    checkpoint.radiusPerImageQueue = radiusPerImageQueue;
+    checkpoint.altitudePerImageQueue = altitudePerImageQueue;
+    for(const cv::Mat& m : descriptorsQueue)
+        checkpoint.descriptorsQueue.push_back(m.clone());
+    for(const cv::Mat& m : opticsQueue)
+        checkpoint.opticsQueue.push_back(m.clone());
+    checkpoint.keypointsQueue = keypointsQueue;
+    checkpoint.estimatedAngularVelocities = estimatedAngularVelocities;
+    checkpoint.active = active;
+    return checkpoint;
+}
+
+void Vision::restoreCheckpoint(const VisionCheckpoint& checkpoint){
+    std::scoped_lock<std::mutex> lock(processingLock);
+    opticCount = checkpoint.opticCount;
+    matchCount = checkpoint.matchCount;
+    featureCount = checkpoint.featureCount;
+    radiusPerImageQueue = checkpoint.radiusPerImageQueue;
+    altitudePerImageQueue = checkpoint.altitudePerImageQueue;
+    descriptorsQueue.clear();
+    for(const cv::Mat& m : checkpoint.descriptorsQueue)
+        descriptorsQueue.push_back(m.clone());
+    opticsQueue.clear();
+    for(const cv::Mat& m : checkpoint.opticsQueue)
+        opticsQueue.push_back(m.clone());
+    keypointsQueue = checkpoint.keypointsQueue;
+    estimatedAngularVelocities = checkpoint.estimatedAngularVelocities;
+    active = checkpoint.active;
+}
@@ -6,9 +6,24 @@
 #include <mutex>
 #include "lander_navstruct.h"
 
+struct BenchmarkAccess; //benchmarks/ times the private image processing stages directly
+
 namespace Lander{
 
+    //everything vision has accumulated, images and descriptors are deep copied so a restored run doesnt share them
+    struct VisionCheckpoint{
+        int opticCount, matchCount, featureCount;
+        std::deque<float> radiusPerImageQueue;
+        std::deque<float> altitudePerImageQueue;
+        std::deque<cv::Mat> descriptorsQueue;
+        std::deque<cv::Mat> opticsQueue;
+        std::deque<std::vector<cv::KeyPoint>> keypointsQueue;
+        std::vector<glm::vec3> estimatedAngularVelocities;
+        bool active;
+    };
+
     class Vision{
+        friend struct ::BenchmarkAccess;
 
     private:
 
@@ -54,9 +69,14 @@ namespace Lander{
 
     bool active = true;
 
+    bool synchronous = false; //process each image on the calling thread, used by headless runs where sim time outpaces a detached thread
+
     void init(Mediator* mediator, float imageTimer, NavigationStruct* gncVars);
 
     void simulationTick();
+
+    VisionCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const VisionCheckpoint& checkpoint);
     
 
     };
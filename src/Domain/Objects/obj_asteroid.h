@@ -6,6 +6,8 @@
 #include <BulletCollision/Gimpact/btGImpactShape.h>
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <glm/gtx/string_cast.hpp>
+#include <memory>
+#include "sv_collisionCache.h"
 
 struct AsteroidObj : virtual CollisionRenderObj{
     float maxRotationVelocity = 0.025f;
@@ -13,28 +15,61 @@ struct AsteroidObj : virtual CollisionRenderObj{
     btQuaternion initialRotation;
     btVector3 angularVelocity;
 
+    bool kinematic = true; //false gives the old dynamic gimpact body, kept for comparing contact behaviour
+    std::unique_ptr<btTriangleMesh> triangleMesh; //the shapes only reference it, must outlive them
+    std::unique_ptr<Service::CookedTriangleMesh> cookedMesh; //used instead of triangleMesh when the kinematic shape came from the cache
+
     void init(btAlignedObjectArray<btCollisionShape*>* collisionShapes, btDiscreteDynamicsWorld* dynamicsWorld, Mediator& r_mediator){
         std::vector<Vertex>& allV = r_mediator.renderer_getAllVertices(); //reference all loaded model vertices
         std::vector<uint32_t>& allI = r_mediator.renderer_getAllIndices(); //reference all loaded model indices
-    
-        btGImpactMeshShape* collisionShape;
 
-        if(!collisionShape){
-            btTriangleMesh *mTriMesh = new btTriangleMesh(true, false);
+        btVector3 btScale(scale.x, scale.y, scale.z);
+        btCollisionShape* collisionShape = nullptr;
+        uint64_t cacheKey = 0;
+        if(kinematic){
+            //a cooked mesh skips the duplicate vertex search in addTriangle and the bvh build
+            std::vector<float> corners;
+            corners.reserve(indexCount*3);
+            for (int i = indexBase; i < indexBase+indexCount; i++)
+                corners.insert(corners.end(), {allV[allI[i]].pos.x, allV[allI[i]].pos.y, allV[allI[i]].pos.z});
+            cacheKey = Service::cookedMeshKey(corners.data(), corners.size(), btScale);
+
+            cookedMesh = std::make_unique<Service::CookedTriangleMesh>();
+            if(cookedMesh->load(Service::cookedMeshPath(cacheKey), cacheKey)){
+                cookedMesh->getMeshInterface()->setScaling(btScale);
+                btBvhTriangleMeshShape* bvhShape = new btBvhTriangleMeshShape(cookedMesh->getMeshInterface(), true, false);
+                bvhShape->setOptimizedBvh(cookedMesh->getBvh(), btScale);
+                collisionShape = bvhShape;
+            }
+            else
+                cookedMesh.reset();
+        }
 
+        if(collisionShape == nullptr){ //not cooked yet, or the gimpact body
+            triangleMesh = std::make_unique<btTriangleMesh>(true, false);
             //create a trimesh by stepping through allVertices using allIndices to select the correct vertices
             for (int i = indexBase; i < indexBase+indexCount; i+=3) {
                 btVector3 v1(allV[allI[i]].pos.x, allV[allI[i]].pos.y, allV[allI[i]].pos.z);
                 btVector3 v2(allV[allI[i+1]].pos.x, allV[allI[i+1]].pos.y, allV[allI[i+1]].pos.z);
                 btVector3 v3(allV[allI[i+2]].pos.x, allV[allI[i+2]].pos.y, allV[allI[i+2]].pos.z);
-                mTriMesh->addTriangle(v1, v2, v3, true);
+                triangleMesh->addTriangle(v1, v2, v3, true);
             }
-            collisionShape = new btGImpactMeshShape(mTriMesh);
-        }
 
-        //asteroidCollisionShape->setMargin(0.05);
-        collisionShape->setLocalScaling(btVector3(scale.x, scale.y, scale.z));
-        collisionShape->updateBound();// Call this method once before doing collisions 
+            if(kinematic){
+                //scale the mesh before the quantized bvh is built, setLocalScaling on the shape would build it twice
+                triangleMesh->setScaling(btScale);
+                btBvhTriangleMeshShape* bvhShape = new btBvhTriangleMeshShape(triangleMesh.get(), true, true);
+                Service::CookedTriangleMesh::write(Service::cookedMeshPath(cacheKey), cacheKey, *triangleMesh, *bvhShape->getOptimizedBvh());
+                collisionShape = bvhShape;
+            }
+            else{
+                btGImpactMeshShape* gimpactShape = new btGImpactMeshShape(triangleMesh.get());
+                //asteroidCollisionShape->setMargin(0.05);
+                gimpactShape->setLocalScaling(btScale);
+                gimpactShape->updateBound();// Call this method once before doing collisions 
+                collisionShape = gimpactShape;
+            }
+        }
         collisionShapes->push_back(collisionShape);
 
         btTransform transform;
@@ -42,7 +77,8 @@ struct AsteroidObj : virtual CollisionRenderObj{
 
         initTransform(&transform);
 
-        btScalar btMass(mass);
+        //kinematic bodies have no mass, bullet treats them as infinitely heavy and we move them ourselves
+        btScalar btMass(kinematic ? 0 : mass);
         //rigidbody is dynamic if and only if mass is non zero, otherwise static
         bool isDynamic = (btMass != 0.f);
         btVector3 localInertia(0, 0, 0);
@@ -54,6 +90,8 @@ struct AsteroidObj : virtual CollisionRenderObj{
         btRigidBody::btRigidBodyConstructionInfo rbInfo(btMass, myMotionState, collisionShape, localInertia);
         rbInfo.m_friction = 1.0f; //5 is sticky
         btRigidBody* rigidbody = new btRigidBody(rbInfo);
+        if(kinematic)
+            rigidbody->setCollisionFlags(rigidbody->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
         rigidbody->setActivationState(DISABLE_DEACTIVATION); //stop body from disabling collision, bullet threshholds are pretty loose
 
         initRigidBody(&transform, rigidbody);
@@ -62,10 +100,22 @@ struct AsteroidObj : virtual CollisionRenderObj{
     }
 
     void timestepBehaviour(btRigidBody* body, float timeStep){
-        //we are clearing forces on timestep because while lander is in contact bullet will sometimes apply a small force on the asteroid, despite mass difference
-        body->clearForces();
+        if(!kinematic){
+            //we are clearing forces on timestep because while lander is in contact bullet will sometimes apply a small force on the asteroid, despite mass difference
+            body->clearForces();
+            body->setLinearVelocity(btVector3(0,0,0));
+            return;
+        }
+
+        //advance the prescribed spin by one substep, runs before collision detection so contacts see this substep's pose
+        //bullet derives kinematic velocities from the motion state once per stepSimulation call, so the spin is set again here for contact friction
+        btTransform next;
+        btTransformUtil::integrateTransform(body->getWorldTransform(), btVector3(0,0,0), angularVelocity, timeStep, next);
+        body->setWorldTransform(next);
+        body->setInterpolationWorldTransform(next);
+        body->getMotionState()->setWorldTransform(next);
         body->setLinearVelocity(btVector3(0,0,0));
-        //angularVelocity = Service::bt2glm(body->getAngularVelocity());
+        body->setAngularVelocity(angularVelocity);
     }
 
     void initTransform(btTransform* transform){
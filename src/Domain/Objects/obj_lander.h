@@ -1,17 +1,35 @@
 #pragma once
 #include "obj_collisionRender.h"
-#include <glm/gtx/fast_square_root.hpp>
 #include "sv_randoms.h"
 #include "lander_cpu.h"
+#include "lander_fleet.h"
 #include <deque>
 #include <mutex>
 #include "obj_spotLight.h"
 
+//lander state that isnt held in its bullet rigid body
+struct LanderCheckpoint{
+    Lander::CPUCheckpoint cpu;
+    Service::RandomStream rng;
+    float landerVelocity;
+    glm::vec3 landerVelocityVector;
+    glm::vec3 landerAngularVelocity;
+    float gravitationalForce;
+    btVector3 landerGravityVector;
+    bool collided;
+    float largestImpactForce;
+};
+
 struct LanderObj : virtual CollisionRenderObj{ //this should impliment an interface for 
     Lander::CPU cpu = Lander::CPU();
 
-    double asteroidGravForceMultiplier;
+    Lander::Fleet* p_fleet = nullptr; //gravity is computed for every lander at once by the fleet
+    int slot = 0; //index in p_fleet, 0 is the primary lander
+    glm::vec3 siteOffset = glm::vec3(0); //formation offset of this lander's target from the shared landing site, 0 for the primary
     float startDistance;
+    Service::RandomStream rng; //seeded by the scene, drives the initial velocity direction
+    LidarData lidarData; //read by the cpu on init
+    Service::RandomStream lidarRng; //lidar range noise, seeded by the scene
     float initialSpeed = 0.00001f; //if 0 we get a black screen on auto camera, lander is in correct pos though, changing focus fixes
     btVector3 asteroidRotationalVelocity = btVector3(0,0,0);
     
@@ -30,9 +48,12 @@ struct LanderObj : virtual CollisionRenderObj{ //this should impliment an interf
 
     bool useEstimateOnly = false; //passed through to gnc
 
+    bool collided = false; //set once the lander has touched down (or gnc has given up), used to end headless runs
+    float largestImpactForce = 0.0f; //largest contact this lander was part of, WorldStats::largestImpactForce covers the whole world
+
     btTransform landerTransform;
     Mediator* p_mediator;
-    WorldSpotLightObject* p_spotlight; 
+    WorldSpotLightObject* p_spotlight = nullptr; //only the primary lander carries the spotlight
     
     void init(btAlignedObjectArray<btCollisionShape*>* collisionShapes, btDiscreteDynamicsWorld* dynamicsWorld, Mediator& r_mediator){
         //colShape->setMargin(0.05);
@@ -120,10 +141,9 @@ struct LanderObj : virtual CollisionRenderObj{ //this should impliment an interf
     }
 
     void timestepBehaviour(btRigidBody* body, float timeStep){
-        //set the gravity for the lander towards the asteroid
-        btVector3 direction = -btVector3(pos.x, pos.y, pos.z); //asteroid is always at origin so dir of gravity is aways towards 0
-        gravitationalForce = asteroidGravForceMultiplier*glm::fastInverseSqrt(direction.distance(btVector3(0,0,0)));
-        landerGravityVector = direction.normalize()*gravitationalForce;
+        //set the gravity for the lander towards the asteroid, the fleet has already worked it out for this substep
+        gravitationalForce = p_fleet->getGravityMagnitude(slot);
+        landerGravityVector = p_fleet->getGravity(slot);
         body->setGravity(landerGravityVector);
         
         //store the linear velocity, 
@@ -143,11 +163,15 @@ struct LanderObj : virtual CollisionRenderObj{ //this should impliment an interf
     //this will be called from world_physics directly from now on, little hacky, need to derive new class from WorldPhysics
     //and seperate out this call and the update landing site calls
     void updateSpotlight(){
+        if(p_spotlight == nullptr)
+            return;
         p_spotlight->pos = glm::vec4(pos, 1.0f) + (rot * glm::vec4(p_spotlight->initialPos, 1.0f)); //we set the light position to that of the initalPos + lander current position
         p_spotlight->direction = rot * glm::vec4(p_spotlight->initialPos, 0.0f); //we are using initialPos of the light as a direction, * landers rotation
     }
 
     void updateWorldStats(WorldStats* worldStats){
+        if(slot != 0)
+            return; //ui shows the primary lander
         //stored for retrival in UI with getGravitationalForce()
         worldStats->landerVelocity = landerVelocity;
         worldStats->gravitationalForce = gravitationalForce;
@@ -158,15 +182,34 @@ struct LanderObj : virtual CollisionRenderObj{ //this should impliment an interf
         //btVector3 direction = -transform->getOrigin(); 
 
         //btVector3 direction = btVector3(0,0,-1); //lets do this for now, this causes black screen as well!
-        btVector3 direction = Service::getPointOnSphere(Service::getRandFloat(0,360), Service::getRandFloat(0,360), 100)-transform->getOrigin(); //why on earth does this work instead
+        btVector3 direction = Service::getPointOnSphere(Service::getRandFloat(rng,0,360), Service::getRandFloat(rng,0,360), 100)-transform->getOrigin(); //why on earth does this work instead
         rigidbody->setLinearVelocity(direction.normalize()*initialSpeed); //start box falling towards asteroid
     }
 
     void landerCollided(){
+        collided = true;
         cpu.setAutopilot(false);
         cpu.setImaging(false);
     }
 
+    LanderCheckpoint saveCheckpoint(){
+        return LanderCheckpoint{cpu.saveCheckpoint(), rng, landerVelocity, landerVelocityVector, landerAngularVelocity, gravitationalForce, landerGravityVector, collided, largestImpactForce};
+    }
+
+    //call after the rigid body has been restored, up and forward are recalculated from it
+    void restoreCheckpoint(const LanderCheckpoint& checkpoint){
+        cpu.restoreCheckpoint(checkpoint.cpu);
+        rng = checkpoint.rng;
+        landerVelocity = checkpoint.landerVelocity;
+        landerVelocityVector = checkpoint.landerVelocityVector;
+        landerAngularVelocity = checkpoint.landerAngularVelocity;
+        gravitationalForce = checkpoint.gravitationalForce;
+        landerGravityVector = checkpoint.landerGravityVector;
+        collided = checkpoint.collided;
+        largestImpactForce = checkpoint.largestImpactForce;
+        updateLanderUpForward(btRigidBody::upcast(p_btCollisionObject));
+    }
+
     void landerSetAutopilot(bool b){
         cpu.setAutopilot(b);
     }
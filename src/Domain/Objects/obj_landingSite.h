@@ -18,6 +18,10 @@ struct LandingSiteObj : virtual WorldObject{
 
     btVector3 angularVelocity; //set by asteroid obj and used by lander, basically just passing through here for convenience
 
+    //resolved in constructLandingSite, used every substep in updateLandingSiteObjects
+    EntityHandle asteroidHandle;
+    EntityHandle boxHandles[4];
+
     LandingSiteObj(Mediator* mediator): p_mediator{mediator}{}
 
     void constructLandingSite(SceneData& sceneData, 
@@ -26,6 +30,7 @@ struct LandingSiteObj : virtual WorldObject{
             MyScene* myScene
             ){
         //first get center of scenario landing site, scale it, 
+        asteroidHandle = myScene->getEntityRegistry().find("Asteroid"); //asteroid must be registered before the landing site is built
         float scaleAmount = sceneData.ASTEROID_SCALE*LANDING_SCALE_REDUCTION_FACTOR;
         glm::mat4 scale_m = glm::scale(glm::mat4(1.0f), glm::vec3(sceneData.ASTEROID_SCALE, sceneData.ASTEROID_SCALE, sceneData.ASTEROID_SCALE)); //scale matrix
         glm::vec3 towardsOrigin = glm::normalize(-sceneData.landingSite.pos)*scaleAmount;
@@ -92,18 +97,27 @@ struct LandingSiteObj : virtual WorldObject{
 
             objects->push_back(landingBox);
             renderableObjects->push_back(landingBox);
+            boxHandles[x] = myScene->getEntityRegistry().add(landingBox);
         }
     }
 
+    //a point offset from the site in the world frame at scene start, it turns with the asteroid the same way the site does
+    glm::vec3 getOffsetPoint(const glm::vec3& initialOffset){
+        return rot*glm::inverse(initialRot)*glm::vec4(initialPos + initialOffset, 1);
+    }
+
     void updateLandingSiteObjects(){
         //get LandingSite WorldObject too and update that first
-        WorldObject& asteroidRenderObject = p_mediator->scene_getFocusableObject("Asteroid");
+        WorldObject* p_asteroid = p_mediator->scene_getEntity(asteroidHandle);
+        if(p_asteroid == nullptr)
+            return;
+        WorldObject& asteroidRenderObject = *p_asteroid;
         glm::vec3 rotated_point = asteroidRenderObject.rot * glm::vec4(initialPos, 1);
         pos = rotated_point;
         rot = asteroidRenderObject.rot*initialRot;
         
         for(int x = 0; x < 4; x++){
-            WorldObject& box = p_mediator->scene_getWorldObject(4+x); //4 is the first index of landing box in the world object list ISSUE - need an object mgr
+            WorldObject& box = *p_mediator->scene_getEntity(boxHandles[x]);
             //glm::vec3 directionToOrigin = glm::normalize(-initialPos);
             glm::vec3 rotated_point = asteroidRenderObject.rot * glm::vec4(box.initialPos, 1);
             box.pos = rotated_point;
@@ -132,7 +146,7 @@ struct LandingSiteObj : virtual WorldObject{
 
             initialRot = glm::yawPitchRoll(glm::radians(yaw), glm::radians(pitch), glm::radians(roll));
             for(int x = 0; x < 4; x++){
-                WorldObject& box = p_mediator->scene_getWorldObject(4+x); //4 is the first index of landing box in the world object list
+                WorldObject& box = *p_mediator->scene_getEntity(boxHandles[x]);
                 box.initialRot = initialRot;
 
                 glm::vec3 landingBoxPos;
@@ -161,7 +175,7 @@ struct LandingSiteObj : virtual WorldObject{
             pos += correctedDirection/10.0f;
             initialPos = pos;
             for(int x = 0; x < 4; x++){
-                WorldObject& box = p_mediator->scene_getWorldObject(4+x); //4 is the first index of landing box in the world object list
+                WorldObject& box = *p_mediator->scene_getEntity(boxHandles[x]);
                 box.pos += correctedDirection/10.0f;
                 box.initialPos = box.pos;
             }
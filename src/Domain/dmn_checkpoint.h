@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <bullet/btBulletDynamicsCommon.h>
+#include "world_stats.h"
+#include "obj_lander.h"
+
+//bullet state of one rigid body, the gravity is kept because bullet applies it from the previous tick's setGravity
+struct RigidBodyCheckpoint{
+    btTransform transform;
+    btVector3 linearVelocity;
+    btVector3 angularVelocity;
+    btVector3 gravity;
+};
+
+//snapshot of a running scene, taken and restored by WorldPhysics between steps
+//restore into the same scene (or one loaded from the same SceneData) to branch several runs from a shared prefix
+//exact on the SimClock, in WallClock mode bullet's internal time remainder isnt captured
+struct SimCheckpoint{
+    double systemTimeStamp;
+    uint64_t simStepCount;
+    float pendingSubSteps;
+    WorldStats worldStats;
+    std::vector<RigidBodyCheckpoint> bodies; //same order as the scene's collision objects, includes the asteroid rotation
+    std::vector<LanderCheckpoint> landers; //one per lander fleet slot
+};
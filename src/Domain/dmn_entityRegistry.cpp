@@ -0,0 +1,37 @@
+#include "dmn_entityRegistry.h"
+#include "obj.h"
+#include <atomic>
+
+//shared by every registry so handles never collide between scenes, including headless campaign runs on other threads
+static std::atomic<uint32_t> nextGeneration = 1;
+
+EntityRegistry::EntityRegistry(): generation{nextGeneration++}{}
+
+EntityHandle EntityRegistry::add(std::shared_ptr<WorldObject> object, const std::string& name){
+    EntityHandle handle;
+    handle.index = objects.size();
+    handle.generation = generation;
+    objects.push_back(object);
+    if(!name.empty())
+        names[name] = handle;
+    return handle;
+}
+
+WorldObject* EntityRegistry::get(EntityHandle handle) const{
+    if(handle.generation != generation || handle.index >= objects.size())
+        return nullptr;
+    return objects[handle.index].get();
+}
+
+EntityHandle EntityRegistry::find(const std::string& name) const{
+    auto it = names.find(name);
+    if(it == names.end())
+        return EntityHandle();
+    return it->second;
+}
+
+void EntityRegistry::clear(){
+    objects.clear();
+    names.clear();
+    generation = nextGeneration++;
+}
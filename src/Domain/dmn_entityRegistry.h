@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+class WorldObject;
+
+//stable reference to a scene object, resolve it once when the scene loads instead of looking objects up by name or list index every tick
+//generations are unique across registries, so a handle kept from a previous scene resolves to nullptr rather than a different object
+struct EntityHandle{
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+    bool isValid() const {return index != UINT32_MAX;};
+};
+
+//owns the scene's lookup table of world objects, get() is a bounds and generation check then an index
+class EntityRegistry{
+    public:
+        EntityRegistry();
+        EntityHandle add(std::shared_ptr<WorldObject> object, const std::string& name = ""); //named objects can be found with find()
+        WorldObject* get(EntityHandle handle) const; //nullptr if the handle is invalid or from an older scene
+        EntityHandle find(const std::string& name) const; //map lookup, use when resolving handles not per tick
+        void clear(); //invalidates every handle given out so far
+        size_t size() const {return objects.size();};
+    private:
+        std::vector<std::shared_ptr<WorldObject>> objects;
+        std::unordered_map<std::string, EntityHandle> names;
+        uint32_t generation;
+};
@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <stdexcept>
+#include "dmn_entityRegistry.h"
 
 class WorldObject;
 class CollisionRenderObj;
@@ -33,7 +35,7 @@ class IScene{
         std::vector<std::shared_ptr<WorldObject>> objects;
         std::vector<std::shared_ptr<CollisionRenderObj>> collisionObjects;
         std::vector<std::shared_ptr<RenderObject>> renderableObjects;
-        std::unordered_map<std::string, std::shared_ptr<WorldObject>> focusableObjects;
+        EntityRegistry entities; //every world object, focusable ones are registered by name
         std::vector<std::shared_ptr<RenderObject>> debugObjects;
 
     public:
@@ -41,7 +43,14 @@ class IScene{
         int getNumSpotLights(){return spotLights.size();}
         int getWorldObjectsCount(){return objects.size();}
         WorldObject& getWorldObject(int i){return *objects.at(i);}
-        WorldObject& getFocusableObject(std::string name){return *focusableObjects.at(name);};
+        WorldObject& getFocusableObject(std::string name){
+            WorldObject* object = entities.get(entities.find(name));
+            if(object == nullptr)
+                throw std::out_of_range("No focusable object named " + name);
+            return *object;
+        };
+        WorldObject* getEntity(EntityHandle handle){return entities.get(handle);};
+        EntityRegistry& getEntityRegistry(){return entities;};
         std::vector<std::shared_ptr<RenderObject>>* getDebugObjects(){return &debugObjects;};
         virtual void initScene(SceneData data) = 0;
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <glm/gtx/string_cast.hpp>
 #include "obj_landingSite.h"
 #include <glm/gtx/quaternion.hpp>
+#include <iostream>
+#include <cmath>
 
 MyScene::MyScene(Mediator& mediator): r_mediator{mediator}{}
 
@@ -15,6 +17,9 @@ void MyScene::setSceneData(SceneData isceneData){
 
 void MyScene::initScene(SceneData latestSceneData){
     sceneData = latestSceneData;
+    if(sceneData.SEED == 0)
+        sceneData.SEED = Service::getFreshSeed();
+    std::cout << "Scenario seed: " << sceneData.SEED << "\n";
     r_mediator.ui_updateLoadingProgress(0.1f, "loading models...");
     r_mediator.renderer_loadModels(MODEL_INFOS);
     r_mediator.ui_updateLoadingProgress(0.25f, "loading textures...");
@@ -47,7 +52,7 @@ void MyScene::configureRenderEngine(){
 
 void MyScene::configurePhysicsEngine(){
     r_mediator.physics_reset();
-    r_mediator.physics_loadCollisionMeshes(&collisionObjects);
+    r_mediator.physics_loadCollisionMeshes(&collisionObjects, &landerFleet);
     r_mediator.physics_updateDeltaTime();
 }
 
@@ -59,13 +64,71 @@ void MyScene::setRendererMeshVars(std::string name, RenderObject* renderObj){
     renderObj->indexCount = mesh->indexCount;
 }
 
+//density is set so gravity at the furthest vertex matches the point mass law, GM/R^2 = multiplier/sqrt(R)
+//null if the mesh has no volume, the fleet then keeps the point mass law
+std::shared_ptr<Service::GravityFieldCache> MyScene::createGravityField(RenderObject* asteroid){
+    std::shared_ptr<Service::PolyhedronGravity> model = std::make_shared<Service::PolyhedronGravity>();
+    model->build(r_mediator.renderer_getAllVertices(), r_mediator.renderer_getAllIndices(), asteroid->indexBase, asteroid->indexCount, asteroid->scale);
+    if(model->empty() || model->getVolume() <= 0){
+        std::cout << "Asteroid mesh has no volume, using point mass gravity\n";
+        return nullptr;
+    }
+    if(model->getOpenEdgeCount() > 0)
+        std::cout << "Asteroid mesh has " << model->getOpenEdgeCount() << " open edges, polyhedron gravity is approximate\n";
+    double radius = model->getBoundingRadius();
+    model->setDensityConstant(sceneData.GRAVITATIONAL_FORCE_MULTIPLIER*radius*std::sqrt(radius)/model->getVolume());
+    return std::make_shared<Service::GravityFieldCache>(model);
+}
+
+//slot 0 stays on the approach axis, the rest fill a square grid beside it
+glm::vec3 MyScene::getFormationOffset(int slot){
+    int side = std::ceil(std::sqrt((float)sceneData.NUM_LANDERS));
+    return glm::vec3(slot % side, slot / side, 0)*sceneData.LANDER_SPACING;
+}
+
+std::shared_ptr<LanderObj> MyScene::createLander(int id, int slot){
+    std::shared_ptr<LanderObj> lander = std::shared_ptr<LanderObj>(new LanderObj());
+    lander->id = id;
+    lander->scale = glm::vec3(1.0f,1.0f,1.0f);
+    setRendererMeshVars("lander", lander.get());   //instead of box and default mesh we need to assign the model
+    lander->material = r_mediator.renderer_getMaterial("texturedmesh2");
+    lander->material->extra.x = 64;
+    lander->mass = 1.0f;
+
+    lander->startDistance = sceneData.LANDER_START_DISTANCE;
+    lander->useEstimateOnly = sceneData.USE_ONLY_ESTIMATE;
+    lander->lidarData = sceneData.lidar;
+    if(slot == 0){
+        lander->rng = Service::RandomStream(sceneData.SEED, Service::RNG_STREAM_LANDER);
+        lander->lidarRng = Service::RandomStream(sceneData.SEED, Service::RNG_STREAM_LIDAR);
+    }
+    else{
+        lander->rng = Service::RandomStream(sceneData.SEED, Service::RNG_STREAM_LANDER_FLEET + slot);
+        lander->lidarRng = Service::RandomStream(sceneData.SEED, Service::RNG_STREAM_LIDAR_FLEET + slot);
+    }
+
+    lander->p_fleet = &landerFleet;
+    lander->slot = landerFleet.add(lander.get());
+    landers.push_back(lander);
+
+    objects.push_back(lander);
+    renderableObjects.push_back(lander);
+    collisionObjects.push_back(lander);
+    entities.add(lander, slot == 0 ? "Lander" : "Lander_" + std::to_string(slot));
+    return lander;
+}
+
 void MyScene::initObjects(){ 
     objects.clear();
     renderableObjects.clear();
     collisionObjects.clear();
-    focusableObjects.clear();
+    entities.clear();
     debugObjects.clear();
+    landers.clear();
+    landerFleet.clear();
+    landerFleet.setGravityMultiplier(sceneData.GRAVITATIONAL_FORCE_MULTIPLIER);
     int id = 0;
+    Service::RandomStream scenarioRng = Service::RandomStream(sceneData.SEED, Service::RNG_STREAM_SCENARIO);
 
     std::shared_ptr<RenderObject> skybox = std::shared_ptr<RenderObject>(new RenderObject());
     skybox->id = id++;
@@ -73,6 +136,7 @@ void MyScene::initObjects(){
     skybox->scale = glm::vec3(10000,10000,10000);
     setRendererMeshVars("box", skybox.get());
     objects.push_back(skybox);
+    entities.add(skybox);
     renderableObjects.push_back(skybox);
 
     std::shared_ptr<RenderObject> starSphere = std::shared_ptr<RenderObject>(new RenderObject());
@@ -89,24 +153,11 @@ void MyScene::initObjects(){
     starSphere->altMaterial->specular = glm::vec3(0.5f,0.5f,0.5f);
     starSphere->altMaterial->extra.x = 32;
     objects.push_back(starSphere);
+    entities.add(starSphere);
     renderableObjects.push_back(starSphere);
 
-    lander = std::shared_ptr<LanderObj>(new LanderObj());
-    lander->id = id++;
-    lander->scale = glm::vec3(1.0f,1.0f,1.0f);
-    setRendererMeshVars("lander", lander.get());   //instead of box and default mesh we need to assign the model
-    lander->material = r_mediator.renderer_getMaterial("texturedmesh2");
-    lander->material->extra.x = 64;
-    lander->mass = 1.0f;
-
-    lander->asteroidGravForceMultiplier = sceneData.GRAVITATIONAL_FORCE_MULTIPLIER;
-    lander->startDistance = sceneData.LANDER_START_DISTANCE;
-    lander->useEstimateOnly = sceneData.USE_ONLY_ESTIMATE;
-
-    objects.push_back(lander);
-    renderableObjects.push_back(lander);
-    collisionObjects.push_back(lander);
-    focusableObjects["Lander"] = lander;
+    //the primary lander stays renderable 2 and the asteroid renderable 3, the offscreen renderer draws by index
+    std::shared_ptr<LanderObj> lander = createLander(id++, 0);
 
     std::shared_ptr<AsteroidObj> asteroid = std::shared_ptr<AsteroidObj>(new AsteroidObj());
     asteroid->id = id++;
@@ -125,8 +176,8 @@ void MyScene::initObjects(){
 
     if(sceneData.RANDOMIZE_ROTATION){ //easier if we do this now, then we can pass angular velocity to landing site obj, so lander can get it, simple :)
         float f = sceneData.ASTEROID_MAX_ROTATIONAL_VELOCITY/sceneData.ASTEROID_SCALE;
-        int axis = Service::getRandFloat(0,3);
-        float angle = Service::getAbsMax(Service::getRandFloat(-f,f), sceneData.ASTEROID_MIN_ROTATIONAL_VELOCITY*sceneData.ASTEROID_SCALE);
+        int axis = Service::getRandFloat(scenarioRng,0,3);
+        float angle = Service::getAbsMax(Service::getRandFloat(scenarioRng,-f,f), sceneData.ASTEROID_MIN_ROTATIONAL_VELOCITY*sceneData.ASTEROID_SCALE);
         switch (axis){
         case 0:
             asteroid->angularVelocity = btVector3(angle, 0.0f, 0.0f);
@@ -141,11 +192,11 @@ void MyScene::initObjects(){
 
         //ISSUE more than one axis of rotation also messes things up
         //suspect it may just be my descent checking predictAtTf rotations, because they wont account for angular accelrations over time maybe?
-        //asteroid->angularVelocity = btVector3(Service::getRandFloat(-f,f), Service::getRandFloat(-f,f), Service::getRandFloat(-f,f));
+        //asteroid->angularVelocity = btVector3(Service::getRandFloat(scenarioRng,-f,f), Service::getRandFloat(scenarioRng,-f,f), Service::getRandFloat(scenarioRng,-f,f));
 
         //ISSUE randomizing starting rotation messes up descent checks in lander ai, need to account for initial rotation in there
         //possibly in other locations too, like the zemzev gnc and maybe even landing site?
-        //asteroid->initialRotation.setEulerZYX(Service::getRandFloat(0,359),Service::getRandFloat(0,359),Service::getRandFloat(0,359));
+        //asteroid->initialRotation.setEulerZYX(Service::getRandFloat(scenarioRng,0,359),Service::getRandFloat(scenarioRng,0,359),Service::getRandFloat(scenarioRng,0,359));
         
     }
     else{
@@ -155,16 +206,27 @@ void MyScene::initObjects(){
     objects.push_back(asteroid);
     renderableObjects.push_back(asteroid);   
     collisionObjects.push_back(asteroid);
-    focusableObjects["Asteroid"] = asteroid;
+    entities.add(asteroid, "Asteroid");
+    if(sceneData.GRAVITY_MODEL == GRAVITY_POLYHEDRON)
+        landerFleet.setGravityField(createGravityField(asteroid.get()), asteroid.get());
 
     landingSite = std::shared_ptr<LandingSiteObj>(new LandingSiteObj(&r_mediator));
     landingSite.get()->constructLandingSite(sceneData, &objects, &renderableObjects, this);
-    focusableObjects["Landing_Site"] = landingSite;
+    entities.add(landingSite, "Landing_Site");
     landingSite->angularVelocity = asteroid->angularVelocity; //for convenience
 
+    //secondary landers go after the landing site objects so the indices above dont move
+    id = renderableObjects.size();
+    for(int slot = 1; slot < sceneData.NUM_LANDERS; slot++)
+        createLander(id++, slot);
+
     //try to start around 1000m altitude with optics fov scaled by the asteroid size
-    lander->pos = glm::vec3(0, 0, sceneData.LANDER_START_DISTANCE+(landingSite->pos.z));
-    lander->asteroidScale = sceneData.ASTEROID_SCALE;
+    //each lander aims for the landing site moved by the same offset it starts at, so the formation lands as it flew
+    for(std::shared_ptr<LanderObj>& formationLander : landers){
+        formationLander->siteOffset = getFormationOffset(formationLander->slot);
+        formationLander->pos = glm::vec3(0, 0, sceneData.LANDER_START_DISTANCE+(landingSite->pos.z)) + formationLander->siteOffset;
+        formationLander->asteroidScale = sceneData.ASTEROID_SCALE;
+    }
 
     if(Service::OUTPUT_TEXT){
         //output scenario data to file, shouldn't really be here but all the data is here so...
@@ -172,7 +234,8 @@ void MyScene::initObjects(){
         r_mediator.writer_writeToFile("PARAMS", "Scale:" + std::to_string(sceneData.ASTEROID_SCALE));
         r_mediator.writer_writeToFile("PARAMS", "AngularVelocity:" + glm::to_string(Service::bt2glm(asteroid->angularVelocity)));
         r_mediator.writer_writeToFile("PARAMS", "LanderStartPos:" + glm::to_string(lander->pos));
-        r_mediator.writer_writeToFile("PARAMS", "GravityMultiplier:" + std::to_string(lander->asteroidGravForceMultiplier));
+        r_mediator.writer_writeToFile("PARAMS", "GravityMultiplier:" + std::to_string(sceneData.GRAVITATIONAL_FORCE_MULTIPLIER));
+        r_mediator.writer_writeToFile("PARAMS", "GravityModel:" + std::to_string(sceneData.GRAVITY_MODEL));
     }
 }
 
@@ -213,7 +276,7 @@ void MyScene::initLights(){
     spotlight.cutoffs = {glm::cos(spotlight.cutoffAngles.x), glm::cos(spotlight.cutoffAngles.y)};
     spotLights.push_back(spotlight);
 
-    lander.get()->p_spotlight = &spotLights.at(0); //hacky, our lander needs the world spotlight obj to update its pos and direction each frame
+    landers.at(0)->p_spotlight = &spotLights.at(0); //hacky, our lander needs the world spotlight obj to update its pos and direction each frame
     //however this shouldnt be controlled by lander timestep because its unnecessary to update it until we want to draw it, ie physics engine doesnt matter
 
     if(Service::OUTPUT_TEXT){
@@ -3,6 +3,7 @@
 #include "mediator.h"
 #include <string>
 #include "data_scene.h"
+#include "lander_fleet.h"
 
 class MyScene: public IScene{
         public:
@@ -14,7 +15,8 @@ class MyScene: public IScene{
         void setSceneData(SceneData sceneData);
         void setRendererMeshVars(std::string name, RenderObject* renderObj);
         LandingSiteObj* getLandingSiteObject(){return landingSite.get();};
-        LanderObj* getLanderObject(){return lander.get();};
+        LanderObj* getLanderObject(int slot = 0){return slot < landers.size() ? landers[slot].get() : nullptr;};
+        Lander::Fleet* getLanderFleet(){return &landerFleet;};
         SceneData* getSceneData(){return &sceneData;};
         
         private:
@@ -23,12 +25,16 @@ class MyScene: public IScene{
         void initRenderables();
         void configureRenderEngine();
         void configurePhysicsEngine();
+        std::shared_ptr<LanderObj> createLander(int id, int slot);
+        glm::vec3 getFormationOffset(int slot);
+        std::shared_ptr<Service::GravityFieldCache> createGravityField(RenderObject* asteroid);
         
         glm::mat4 rotation_from_euler(double roll, double pitch, double yaw);
         Mediator& r_mediator;
 
         std::shared_ptr<LandingSiteObj> landingSite; //pointers passed by mediator for ease so we store them in scene
-        std::shared_ptr<LanderObj> lander; //pointers passed by mediator for ease so we store them in scene
+        std::vector<std::shared_ptr<LanderObj>> landers; //pointers passed by mediator for ease so we store them in scene, slot 0 is the primary lander
+        Lander::Fleet landerFleet;
 
         //model identifier and path pairs, for assigning to unnordered map, loading code needs cleaned and moved
         const std::vector<ModelInfo> MODEL_INFOS = {
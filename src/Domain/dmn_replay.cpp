@@ -0,0 +1,193 @@
+#include "dmn_replay.h"
+#include "obj_collisionRender.h"
+#include "obj_landingSite.h"
+#include "obj_lander.h"
+#include "mediator.h"
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <iostream>
+
+static_assert(std::is_trivially_copyable<SceneData>::value, "SceneData is written to replay files as is");
+
+bool ReplayRecorder::open(const std::string& path, const SceneData& sceneData, size_t numBodies){
+    close();
+    streamBuffer = std::make_unique<char[]>(STREAM_BUFFER_BYTES);
+    file.rdbuf()->pubsetbuf(streamBuffer.get(), STREAM_BUFFER_BYTES); //must be set before open to take effect
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()){
+        std::cout << "Unable to open replay file " + path + "\n";
+        return false;
+    }
+
+    uint32_t bodies = numBodies;
+    uint32_t sceneDataSize = sizeof(SceneData);
+    file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    file.write(reinterpret_cast<const char*>(&REPLAY_VERSION), sizeof(REPLAY_VERSION));
+    file.write(reinterpret_cast<const char*>(&bodies), sizeof(bodies));
+    file.write(reinterpret_cast<const char*>(&sceneDataSize), sizeof(sceneDataSize));
+    file.write(reinterpret_cast<const char*>(&sceneData), sizeof(SceneData));
+
+    lastPoses.assign(numBodies + 1, ReplayPose{});
+    mask.assign((numBodies + 8)/8, 0);
+    firstFrame = true;
+    return true;
+}
+
+void ReplayRecorder::writePose(const ReplayPose& pose){
+    float values[7] = {pose.pos.x, pose.pos.y, pose.pos.z, pose.rot.x, pose.rot.y, pose.rot.z, pose.rot.w};
+    file.write(reinterpret_cast<const char*>(values), sizeof(values));
+}
+
+void ReplayRecorder::recordFrame(const std::vector<std::shared_ptr<CollisionRenderObj>>& bodies, const LandingSiteObj& landingSite){
+    if(!file.is_open() || bodies.size() + 1 != lastPoses.size())
+        return;
+
+    std::fill(mask.begin(), mask.end(), 0);
+    for(size_t i = 0; i <= bodies.size(); i++){
+        ReplayPose pose = i < bodies.size() ? ReplayPose{bodies[i]->pos, glm::quat_cast(bodies[i]->rot)} : ReplayPose{landingSite.pos, glm::quat_cast(landingSite.rot)};
+        if(firstFrame || !(pose == lastPoses[i])){
+            mask[i/8] |= 1 << (i % 8);
+            lastPoses[i] = pose;
+        }
+    }
+    firstFrame = false;
+
+    uint8_t type = REPLAY_FRAME;
+    file.write(reinterpret_cast<const char*>(&type), sizeof(type));
+    file.write(reinterpret_cast<const char*>(&recordTime), sizeof(recordTime));
+    file.write(reinterpret_cast<const char*>(mask.data()), mask.size());
+    for(size_t i = 0; i < lastPoses.size(); i++){
+        if(mask[i/8] & (1 << (i % 8)))
+            writePose(lastPoses[i]);
+    }
+}
+
+void ReplayRecorder::recordBoost(const glm::vec3& vector){
+    if(!file.is_open())
+        return;
+    uint8_t type = REPLAY_BOOST;
+    float values[3] = {vector.x, vector.y, vector.z};
+    file.write(reinterpret_cast<const char*>(&type), sizeof(type));
+    file.write(reinterpret_cast<const char*>(&recordTime), sizeof(recordTime));
+    file.write(reinterpret_cast<const char*>(values), sizeof(values));
+}
+
+void ReplayRecorder::close(){
+    if(file.is_open())
+        file.close();
+}
+
+//---------------------------------------------------------------- player
+
+template<typename T> bool ReplayPlayer::read(T& value){
+    if(cursor + sizeof(T) > data.size())
+        return false;
+    std::memcpy(&value, data.data() + cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+bool ReplayPlayer::open(const std::string& path){
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file.is_open())
+        return false;
+    data.resize(file.tellg());
+    file.seekg(0);
+    file.read(data.data(), data.size());
+    if(!file)
+        return false;
+
+    cursor = 0;
+    char magic[sizeof(REPLAY_MAGIC)];
+    uint32_t version = 0, sceneDataSize = 0;
+    if(!read(magic) || !read(version) || !read(numBodies) || !read(sceneDataSize))
+        return false;
+    if(std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 || version != REPLAY_VERSION || sceneDataSize != sizeof(SceneData))
+        return false;
+    if(!read(sceneData))
+        return false;
+
+    poses.assign(numBodies + 1, ReplayPose{glm::vec3(0), glm::quat(1, 0, 0, 0)});
+    mask.assign((numBodies + 8)/8, 0);
+    playTime = 0;
+    double firstTime;
+    if(peekTime(firstTime))
+        playTime = firstTime;
+    return true;
+}
+
+bool ReplayPlayer::peekTime(double& time){
+    if(cursor + 1 + sizeof(double) > data.size())
+        return false;
+    std::memcpy(&time, data.data() + cursor + 1, sizeof(double));
+    return true;
+}
+
+void ReplayPlayer::advance(double seconds, std::vector<std::shared_ptr<CollisionRenderObj>>& bodies, LandingSiteObj& landingSite, Mediator& mediator){
+    if(bodies.size() != numBodies){
+        cursor = data.size(); //scene doesnt match the recording
+        return;
+    }
+
+    double target = playTime + seconds;
+    bool applied = false;
+    bool jumpedBack = false;
+    double nextTime;
+    while(peekTime(nextTime) && nextTime <= target){
+        jumpedBack = nextTime < playTime;
+        uint8_t type = 0;
+        double time = 0;
+        read(type);
+        read(time);
+
+        if(type == REPLAY_FRAME){
+            if(cursor + mask.size() > data.size()){
+                cursor = data.size(); //truncated by a killed run
+                break;
+            }
+            std::memcpy(mask.data(), data.data() + cursor, mask.size());
+            cursor += mask.size();
+            for(uint32_t i = 0; i <= numBodies; i++){
+                if(!(mask[i/8] & (1 << (i % 8))))
+                    continue;
+                float values[7];
+                if(!read(values)){
+                    cursor = data.size();
+                    break;
+                }
+                poses[i] = ReplayPose{glm::vec3(values[0], values[1], values[2]), glm::quat(values[6], values[3], values[4], values[5])};
+            }
+            applied = true;
+        }
+        else if(type == REPLAY_BOOST){
+            float values[3];
+            if(!read(values)){
+                cursor = data.size();
+                break;
+            }
+            mediator.ui_submitBoostCommand(LanderBoostCommand{1.0f, glm::vec3(values[0], values[1], values[2]), false});
+        }
+        else{
+            cursor = data.size(); //unknown record, nothing after it can be trusted
+            break;
+        }
+
+        playTime = time;
+        if(jumpedBack)
+            break;
+    }
+    if(!jumpedBack && !isFinished())
+        playTime = target;
+
+    if(!applied)
+        return;
+    for(uint32_t i = 0; i < numBodies; i++){
+        bodies[i]->pos = poses[i].pos;
+        bodies[i]->rot = glm::mat4_cast(poses[i].rot);
+    }
+    landingSite.updateLandingSiteObjects(); //markers follow the asteroid
+    landingSite.pos = poses.back().pos;
+    landingSite.rot = glm::mat4_cast(poses.back().rot);
+    mediator.scene_getLanderObject()->updateSpotlight();
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "data_scene.h"
+
+struct CollisionRenderObj;
+struct LandingSiteObj;
+class Mediator;
+
+//replay file, little endian as written by the host:
+//header: REPLAY_MAGIC (8 bytes), uint32 version, uint32 numBodies, uint32 sizeof(SceneData), SceneData as loaded (seed resolved)
+//records: uint8 type, float64 sim time, then
+//  REPLAY_FRAME: (numBodies + 8)/8 byte mask, bit i set if body i changed since the last frame, bit numBodies the landing site, then a ReplayPose per set bit
+//  REPLAY_BOOST: float32[3] thrust vector, lander local frame
+//bodies are the scene's collision objects in load order, time goes backwards where a checkpoint was restored
+const char REPLAY_MAGIC[8] = {'L','S','R','E','P','L','A','Y'};
+const uint32_t REPLAY_VERSION = 2; //1 had a single mask byte, so at most 7 bodies
+
+enum ReplayRecordType : uint8_t{REPLAY_FRAME = 0, REPLAY_BOOST = 1};
+
+struct ReplayPose{
+    glm::vec3 pos;
+    glm::quat rot;
+    bool operator==(const ReplayPose& other) const{return pos == other.pos && rot == other.rot;};
+};
+
+//writes the render pose of every collision object and the landing site each physics substep, plus thrust events
+//only the physics thread calls it, the file stream is buffered so a substep is a few small copies
+class ReplayRecorder{
+    public:
+        ~ReplayRecorder(){close();};
+        bool open(const std::string& path, const SceneData& sceneData, size_t numBodies);
+        void setTime(double time){recordTime = time;}; //call when the sim timestamp jumps, eg a checkpoint restore
+        void advanceTime(double seconds){recordTime += seconds;};
+        void recordFrame(const std::vector<std::shared_ptr<CollisionRenderObj>>& bodies, const LandingSiteObj& landingSite);
+        void recordBoost(const glm::vec3& vector);
+        void close();
+
+    private:
+        static const size_t STREAM_BUFFER_BYTES = 1 << 20;
+
+        std::unique_ptr<char[]> streamBuffer; //declared before file so it outlives the stream's final flush
+        std::ofstream file;
+        double recordTime = 0;
+        std::vector<ReplayPose> lastPoses; //last written pose of each body, the landing site is at the back
+        std::vector<uint8_t> mask;
+        bool firstFrame = true;
+
+        void writePose(const ReplayPose& pose);
+};
+
+//plays a replay file back into a loaded scene, no physics or lander cpu runs
+//the whole file is read on open so it can be replayed from an output folder that is about to be cleared
+class ReplayPlayer{
+    public:
+        bool open(const std::string& path); //false if the file cant be read or isnt a replay this build understands
+        const SceneData& getSceneData(){return sceneData;};
+        double getTime(){return playTime;};
+        bool isFinished(){return cursor >= data.size();};
+
+        //moves playback forward by seconds of recorded time and applies the newest poses, boosts passed are sent to the ui
+        //stops early at a backwards time jump so the restored timeline starts from its own first frame
+        void advance(double seconds, std::vector<std::shared_ptr<CollisionRenderObj>>& bodies, LandingSiteObj& landingSite, Mediator& mediator);
+
+    private:
+        std::vector<char> data;
+        size_t cursor = 0;
+        SceneData sceneData;
+        uint32_t numBodies = 0;
+        double playTime = 0;
+        std::vector<ReplayPose> poses; //current pose of each body, the landing site is at the back
+        std::vector<uint8_t> mask;
+
+        template<typename T> bool read(T& value);
+        bool peekTime(double& time);
+};
@@ -10,9 +10,23 @@ void WorldCamera::init(){
    updateAutoCamera(fixedLookRadius);
 }
 
+//resolves by name only on first use or after a scene reload, otherwise its an index into the registry
+WorldObject* WorldCamera::getEntity(EntityHandle& handle, const std::string& name){
+    WorldObject* object = r_mediator.scene_getEntity(handle);
+    if(object == nullptr){
+        handle = r_mediator.scene_findEntity(name);
+        object = r_mediator.scene_getEntity(handle);
+    }
+    return object;
+}
+
 //fixed look code, allows focusing on an object
 void WorldCamera::updateAutoCamera(float cameraDistanceScale){
-    WorldObject& r_object = r_mediator.scene_getFocusableObject(FOCUS_NAMES[objectFocusIndex]);
+    WorldObject* p_object = getEntity(focusHandles[objectFocusIndex], FOCUS_NAMES[objectFocusIndex]);
+    WorldObject* p_asteroid = getEntity(asteroidHandle, "Asteroid");
+    if(p_object == nullptr || p_asteroid == nullptr)
+        return;
+    WorldObject& r_object = *p_object;
     
     glm::vec3 direction;
     glm::vec4 cameraPos;
@@ -25,7 +39,7 @@ void WorldCamera::updateAutoCamera(float cameraDistanceScale){
         cameraPos = glm::mat4(trans)*glm::vec4(r_object.pos, 1.0f);
     }
     else{
-        WorldObject& r_object2 = r_mediator.scene_getFocusableObject("Asteroid");
+        WorldObject& r_object2 = *p_asteroid;
         direction = normalize(r_object2.pos-r_object.pos);
         glm::vec3 dirScaled = direction * cameraDistanceScale;
         glm::mat4 trans = glm::mat4(1.0f);
@@ -46,7 +60,10 @@ void WorldCamera::toggleAutoCamera(){
 
 //update the fixed look camera position
 void WorldCamera::updateFixedLookPosition(){
-    WorldObject& r_object = r_mediator.scene_getFocusableObject(FOCUS_NAMES[objectFocusIndex]);
+    WorldObject* p_object = getEntity(focusHandles[objectFocusIndex], FOCUS_NAMES[objectFocusIndex]);
+    if(p_object == nullptr)
+        return;
+    WorldObject& r_object = *p_object;
     float fixedObjectScaleFactor = std::max(r_object.scale.x/8, 1.0f);
     glm::vec3 newPos;
     if(usingAutoCamera){
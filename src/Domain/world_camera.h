@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <string>
+#include "dmn_entityRegistry.h"
 
 class WorldObject;
 class Mediator;
@@ -29,6 +30,9 @@ private:
     //const std::string FOCUS_NAMES[4] {"Lander", "Asteroid", "Landing_Site", "Debug_Box"};
     const std::string FOCUS_NAMES[3] {"Lander", "Asteroid", "Landing_Site"};
     const int FOCUS_NAMES_SIZE = sizeof(FOCUS_NAMES)/sizeof(FOCUS_NAMES[0]);
+    EntityHandle focusHandles[3]; //matches FOCUS_NAMES, re-resolved when a new scene invalidates them
+    EntityHandle asteroidHandle;
+    WorldObject* getEntity(EntityHandle& handle, const std::string& name);
     int objectFocusIndex = 0;
     CameraData cameraData;
 
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <atomic>
 #include <glm/gtx/fast_square_root.hpp>
 #include "vk_renderer.h"
 #include "obj_collisionRender.h"
@@ -10,9 +11,24 @@
 #include <BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h>
 #include <glm/gtx/string_cast.hpp>
 #include "obj_landingSite.h" //these references should be in a child class derived from WorldPhysics
+#include "obj_asteroid.h"
 #include "obj_lander.h" //these references should be in a child class derived from WorldPhysics
+#include "lander_fleet.h"
 #include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
+#ifdef LS_BULLET_MT
+#include <LinearMath/btThreads.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#endif
 #include "sv_randoms.h"
+#include "dmn_checkpoint.h"
+#include "dmn_replay.h"
+#include "sv_trace.h"
+#include "sv_workerPool.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
 
 void WorldPhysics::updateDeltaTime(){
     auto now = std::chrono::high_resolution_clock::now();
@@ -27,36 +43,411 @@ void WorldPhysics::setSimSpeedMultiplier(float multiplier){
 
 //main simulation tick
 void WorldPhysics::worldTick(){
+    TRACE_ZONE("WorldPhysics::worldTick");
     if(worldStats.timeStepMultiplier != 0){ //if we are not paused
-        float fixedTimeStep = 0.01666666754F/2;
         btScalar timeStep = deltaTime*worldStats.timeStepMultiplier;
-        int maxSubSteps = timeStep/fixedTimeStep + SUBSTEP_SAFETY_MARGIN; //make sure timestep is always less than maxSubSteps
+        btScalar subStep = getAdaptiveSubSteps()*FIXED_TIME_STEP; //bullet keeps its leftover time in seconds, so the substep can change between frames
+        //only the first tick of a frame is cut by limitToNextTimer, later ticks of the same size could step over a cpu timer or lidar scan
+        //bullet's leftover is under the last substep, so below this bound the frame is at most one tick, otherwise tick every substep
+        if(timeStep + wallClockSubStep >= 2*subStep)
+            subStep = FIXED_TIME_STEP;
+        wallClockSubStep = subStep;
+        int maxSubSteps = timeStep/subStep + SUBSTEP_SAFETY_MARGIN; //make sure timestep is always less than maxSubSteps
 
         systemTimeStamp += timeStep; //used to track timestamps for writing to file
 
-        p_dynamicsWorld->stepSimulation(timeStep, maxSubSteps, fixedTimeStep); //step world
+        p_dynamicsWorld->stepSimulation(timeStep, maxSubSteps, subStep); //step world
+        worldStats.physicsStep = subStep;
     }
 }
 
-void WorldPhysics::updateCollisionObjects(float timeStep){
-    //update positions of world objects from similation transforms
+//deterministic step, advances exactly numSubSteps substeps regardless of how long the frame took
+//each substep is stepped on its own with maxSubSteps 0 so bullet doesnt accumulate a float remainder or interpolate
+void WorldPhysics::stepFixed(int numSubSteps){
+    TRACE_ZONE("WorldPhysics::stepFixed");
+    deltaTime = numSubSteps*FIXED_TIME_STEP; //checkCollisions scales impact by deltaTime, keep it equal to the simulated frame
+    int i = 0;
+    while(i < numSubSteps){
+        int stepSubSteps = std::min(getFarFieldSubSteps(), numSubSteps - i);
+        worldStats.farField = stepSubSteps > 0;
+        if(stepSubSteps > 0)
+            propagateFarField(stepSubSteps);
+        else{
+            stepSubSteps = std::min(getAdaptiveSubSteps(), numSubSteps - i);
+            p_dynamicsWorld->stepSimulation(stepSubSteps*FIXED_TIME_STEP, 0);
+        }
+        worldStats.physicsStep = stepSubSteps*FIXED_TIME_STEP;
+        i += stepSubSteps;
+        simStepCount += stepSubSteps;
+        systemTimeStamp = simStepCount*(double)FIXED_TIME_STEP;
+    }
+}
+
+int WorldPhysics::getNextStepSubSteps(){
+    int farFieldSubSteps = getFarFieldSubSteps();
+    return farFieldSubSteps > 0 ? farFieldSubSteps : getAdaptiveSubSteps();
+}
+
+//gap between the bounding spheres of body and the nearest other body, closingSpeed is how fast that gap is shrinking
+//with includeLanders false the other landers are ignored
+float WorldPhysics::getClearance(btRigidBody* body, float* closingSpeed, bool includeLanders){
+    btVector3 center;
+    btScalar radius;
+    body->getCollisionShape()->getBoundingSphere(center, radius);
+    center = body->getWorldTransform()(center);
+
+    float clearance = std::numeric_limits<float>::max();
+    float closing = 0;
+    for(std::shared_ptr<CollisionRenderObj> collisionRenderObj : *p_collisionObjects){
+        btRigidBody* other = btRigidBody::upcast(collisionRenderObj->p_btCollisionObject);
+        if(other == body || (!includeLanders && p_landerFleet->findSlot(other) >= 0))
+            continue;
+        btVector3 otherCenter;
+        btScalar otherRadius;
+        other->getCollisionShape()->getBoundingSphere(otherCenter, otherRadius);
+        otherCenter = other->getWorldTransform()(otherCenter);
+        float gap = center.distance(otherCenter) - radius - otherRadius;
+        if(gap < clearance){
+            clearance = gap;
+            btVector3 towards = (otherCenter - center).normalized();
+            closing = std::max(0.0f, (float)(body->getLinearVelocity() - other->getLinearVelocity()).dot(towards));
+        }
+    }
+    if(closingSpeed)
+        *closingSpeed = closing;
+    return clearance;
+}
+
+bool WorldPhysics::isInContact(btCollisionObject* object){
+    int numManifolds = p_dynamicsWorld->getDispatcher()->getNumManifolds();
+    for (int i = 0; i < numManifolds; i++){
+        btPersistentManifold* contactManifold = p_dynamicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
+        if(contactManifold->getNumContacts() > 0 && (contactManifold->getBody0() == object || contactManifold->getBody1() == object))
+            return true;
+    }
+    return false;
+}
+
+//the timers and the lidar count whole substeps, so the step ends exactly one substep before the next one fires, that substep is then stepped alone
+//they all run in the pre tick and read the pose, asteroid frame and timestamp from the start of the step, so a longer step would fire them early
+int WorldPhysics::limitToNextTimer(int numSubSteps){
+    int untilTimer = std::numeric_limits<int>::max();
+    for(int i = 0; i < p_landerFleet->size(); i++){
+        untilTimer = std::min(untilTimer, p_landerFleet->get(i)->cpu.getSubStepsUntilNextTimer());
+        untilTimer = std::min(untilTimer, p_landerFleet->get(i)->cpu.getSubStepsUntilNextScan());
+    }
+    return std::max(1, std::min(numSubSteps, untilTimer - 1));
+}
+
+int WorldPhysics::getFarFieldSubSteps(){
+    if(!FAR_FIELD_PROPAGATION || p_collisionObjects == nullptr || p_landerFleet == nullptr || p_landerFleet->size() == 0 || replayPlayer)
+        return 0;
+    if(p_landerFleet->anyCollided())
+        return 0;
+    int numSubSteps = limitToNextTimer(FAR_FIELD_MAX_SUBSTEPS);
+
+    //worst case distance each lander covers during the step
+    float seconds = numSubSteps*FIXED_TIME_STEP;
+    std::vector<float> travel(p_landerFleet->size());
+    float maxTravel = 0;
+    for(int i = 0; i < p_landerFleet->size(); i++){
+        btRigidBody* body = p_landerFleet->getBody(i);
+        travel[i] = body->getLinearVelocity().length()*seconds + 0.5f*body->getGravity().length()*seconds*seconds;
+        maxTravel = std::max(maxTravel, travel[i]);
+    }
+
+    //must leave every lander outside the clearance, two landers can both close the gap between them
+    for(int i = 0; i < p_landerFleet->size(); i++){
+        btRigidBody* body = p_landerFleet->getBody(i);
+        if(getClearance(body, nullptr, false) - travel[i] < FAR_FIELD_CLEARANCE)
+            return 0;
+        if(p_landerFleet->size() > 1 && getClearance(body) - travel[i] - maxTravel < ADAPTIVE_FINE_CLEARANCE)
+            return 0;
+    }
+    return numSubSteps;
+}
+
+//the whole world takes one step, so it is as short as the lander closest to trouble needs
+int WorldPhysics::getAdaptiveSubSteps(){
+    if(!ADAPTIVE_TIME_STEP || p_collisionObjects == nullptr || p_landerFleet == nullptr || p_landerFleet->size() == 0)
+        return 1;
+    int numSubSteps = ADAPTIVE_MAX_SUBSTEPS;
+    for(int i = 0; i < p_landerFleet->size() && numSubSteps > 1; i++)
+        numSubSteps = std::min(numSubSteps, getAdaptiveSubSteps(i));
+    return limitToNextTimer(numSubSteps);
+}
+
+int WorldPhysics::getAdaptiveSubSteps(int landerSlot){
+    btRigidBody* body = p_landerFleet->getBody(landerSlot);
+    if(p_landerFleet->get(landerSlot)->collided || isInContact(body))
+        return 1;
+    float closingSpeed;
+    float clearance = getClearance(body, &closingSpeed);
+    if(clearance < ADAPTIVE_FINE_CLEARANCE)
+        return 1;
+
+    float maxClosing = clearance*ADAPTIVE_MAX_CLOSING_FRACTION;
+    if(closingSpeed*ADAPTIVE_MAX_SUBSTEPS*FIXED_TIME_STEP > maxClosing)
+        return std::max(1, (int)(maxClosing/(closingSpeed*FIXED_TIME_STEP)));
+    return ADAPTIVE_MAX_SUBSTEPS;
+}
+
+//one large step with the same tick callbacks bullet would make, the lander cpus and asteroid see the whole step as one substep
+//each lander is moved by rk4 under its point gravity, nothing is near enough to touch them so there are no contacts to solve
+//other dynamic bodies keep their velocities for the step, so a dynamic asteroid still spins
+void WorldPhysics::propagateFarField(int numSubSteps){
+    TRACE_ZONE("WorldPhysics::propagateFarField");
+    btScalar timeStep = numSubSteps*FIXED_TIME_STEP;
+    stepPreTickCallback(p_dynamicsWorld, timeStep); //boosts from this tick are already in the lander velocities, as under bullet
+
+    btScalar half = timeStep/2;
+    for(int i = 0; i < p_landerFleet->size(); i++){
+        btRigidBody* body = p_landerFleet->getBody(i);
+        btVector3 r0 = body->getWorldTransform().getOrigin();
+        btVector3 v0 = body->getLinearVelocity();
+
+        btVector3 a1 = p_landerFleet->gravityAt(r0);
+        btVector3 a2 = p_landerFleet->gravityAt(r0 + v0*half);
+        btVector3 a3 = p_landerFleet->gravityAt(r0 + (v0 + a1*half)*half);
+        btVector3 a4 = p_landerFleet->gravityAt(r0 + (v0 + a2*half)*timeStep);
+        btVector3 position = r0 + timeStep*(v0 + timeStep*(a1 + a2 + a3)/6);
+        btVector3 velocity = v0 + timeStep*(a1 + 2*a2 + 2*a3 + a4)/6;
+
+        btTransform next;
+        btTransformUtil::integrateTransform(body->getWorldTransform(), btVector3(0,0,0), body->getAngularVelocity(), timeStep, next);
+        next.setOrigin(position);
+        body->setWorldTransform(next);
+        body->setInterpolationWorldTransform(next);
+        if(body->getMotionState())
+            body->getMotionState()->setWorldTransform(next);
+        body->setLinearVelocity(velocity);
+        body->setInterpolationLinearVelocity(velocity);
+        body->clearForces();
+    }
+
+    //bullet isnt stepped, so any other dynamic body (eg a non kinematic asteroid) is carried along its velocities here
+    //kinematic bodies were already moved for the whole step by their timestepBehaviour in the pre tick
     for(std::shared_ptr<CollisionRenderObj> collisionRenderObj : *p_collisionObjects){
-        btCollisionObject* obj = collisionRenderObj->p_btCollisionObject;
-        btRigidBody* body = btRigidBody::upcast(obj);
-        btTransform transform = obj->getWorldTransform();
-        
-        btVector3 origin = transform.getOrigin();
-        btQuaternion rotation = transform.getRotation();
-        glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f),rotation.getAngle(),glm::vec3(rotation.getAxis().getX(), rotation.getAxis().getY(), rotation.getAxis().getZ()));
+        btRigidBody* body = btRigidBody::upcast(collisionRenderObj->p_btCollisionObject);
+        if(body == nullptr || body->isStaticOrKinematicObject() || p_landerFleet->findSlot(body) >= 0)
+            continue;
+        btTransform next;
+        btTransformUtil::integrateTransform(body->getWorldTransform(), body->getLinearVelocity(), body->getAngularVelocity(), timeStep, next);
+        body->setWorldTransform(next);
+        body->setInterpolationWorldTransform(next);
+        if(body->getMotionState())
+            body->getMotionState()->setWorldTransform(next);
+        body->clearForces();
+    }
+
+    p_dynamicsWorld->updateAabbs(); //raycasts next tick go through the broadphase
+    stepPostTickCallback(p_dynamicsWorld, timeStep);
+}
+
+void WorldPhysics::setClockMode(ClockMode mode){
+    if(mode == ClockMode::SimClock && clockMode != ClockMode::SimClock){
+        simStepCount = std::llround(systemTimeStamp/FIXED_TIME_STEP); //carry on from the current time
+        pendingSubSteps = 0;
+    }
+    clockMode = mode;
+    worldStats.simClock = (clockMode == ClockMode::SimClock);
+}
+
+void WorldPhysics::toggleClockMode(){
+    if(worldStats.maxThroughput)
+        return; //max throughput only runs on the SimClock
+    setClockMode(clockMode == ClockMode::SimClock ? ClockMode::WallClock : ClockMode::SimClock);
+}
+
+void WorldPhysics::toggleMaxThroughput(){
+    worldStats.maxThroughput = !worldStats.maxThroughput;
+    if(worldStats.maxThroughput){
+        clockModeBeforeMaxThroughput = clockMode;
+        setClockMode(ClockMode::SimClock);
+        lastRenderSimTime = systemTimeStamp;
+        lastRenderTime = std::chrono::high_resolution_clock::now();
+    }
+    else
+        setClockMode(clockModeBeforeMaxThroughput);
+}
+
+//batches are one interactive frame each so impact force stats match the SimClock at 1x
+//stops early if the lander asks for an optics image, so it is rendered at the sim time it was requested
+void WorldPhysics::stepMaxThroughput(){
+    auto start = std::chrono::high_resolution_clock::now();
+    while(!r_mediator.renderer_isOpticsFramePending()){
+        stepFixed(std::max(SIM_CLOCK_SUBSTEPS_PER_CALL, getNextStepSubSteps()));
+        if(std::chrono::duration<double, std::chrono::seconds::period>(std::chrono::high_resolution_clock::now() - start).count() >= MAX_THROUGHPUT_FRAME_BUDGET)
+            break;
+    }
+}
 
-        collisionRenderObj->rot = rotationMatrix;
-        collisionRenderObj->pos = Service::bt2glm(origin);
+//drawing the main view costs far more than a batch of substeps, so in max throughput most frames skip it
+bool WorldPhysics::isRenderDue(){
+    auto now = std::chrono::high_resolution_clock::now();
+    bool due = !worldStats.maxThroughput || worldStats.timeStepMultiplier == 0 || r_mediator.renderer_isOpticsFramePending()
+        || systemTimeStamp - lastRenderSimTime >= MAX_THROUGHPUT_RENDER_INTERVAL
+        || std::chrono::duration<double, std::chrono::seconds::period>(now - lastRenderTime).count() >= MAX_THROUGHPUT_RENDER_GAP;
+    if(due){
+        lastRenderSimTime = systemTimeStamp;
+        lastRenderTime = now;
+    }
+    return due;
+}
 
+void WorldPhysics::updateRealTimeFactor(){
+    auto now = std::chrono::high_resolution_clock::now();
+    double wallSeconds = std::chrono::duration<double, std::chrono::seconds::period>(now - rtfSampleTime).count();
+    if(wallSeconds < RTF_SAMPLE_SECONDS)
+        return;
+    worldStats.realTimeFactor = (systemTimeStamp - rtfSampleSimTime)/wallSeconds;
+    rtfSampleSimTime = systemTimeStamp;
+    rtfSampleTime = now;
+}
+
+//call whenever the timestamp jumps, eg restoring a checkpoint
+void WorldPhysics::resetRealTimeFactor(){
+    rtfSampleSimTime = systemTimeStamp;
+    rtfSampleTime = std::chrono::high_resolution_clock::now();
+    lastRenderSimTime = systemTimeStamp;
+}
+
+void WorldPhysics::updateCollisionObjects(float timeStep){
+    p_landerFleet->updateGravity(); //whole fleet in one pass, each lander's timestepBehaviour reads its own slot
+    //update positions of world objects from similation transforms
+    for(std::shared_ptr<CollisionRenderObj> collisionRenderObj : *p_collisionObjects){
+        btRigidBody* body = btRigidBody::upcast(collisionRenderObj->p_btCollisionObject);
+        updateObjectTransform(collisionRenderObj.get());
         collisionRenderObj->timestepBehaviour(body, timeStep);
         collisionRenderObj->updateWorldStats(&worldStats);       
     }
 }
 
+void WorldPhysics::updateObjectTransform(CollisionRenderObj* collisionRenderObj){
+    btTransform transform = collisionRenderObj->p_btCollisionObject->getWorldTransform();
+    
+    btVector3 origin = transform.getOrigin();
+    btQuaternion rotation = transform.getRotation();
+    glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f),rotation.getAngle(),glm::vec3(rotation.getAxis().getX(), rotation.getAxis().getY(), rotation.getAxis().getZ()));
+
+    collisionRenderObj->rot = rotationMatrix;
+    collisionRenderObj->pos = Service::bt2glm(origin);
+}
+
+void WorldPhysics::saveCheckpoint(SimCheckpoint& checkpoint){
+    checkpoint.systemTimeStamp = systemTimeStamp;
+    checkpoint.simStepCount = simStepCount;
+    checkpoint.pendingSubSteps = pendingSubSteps;
+    checkpoint.worldStats = worldStats;
+    checkpoint.bodies.clear();
+    for(std::shared_ptr<CollisionRenderObj> collisionRenderObj : *p_collisionObjects){
+        btRigidBody* body = btRigidBody::upcast(collisionRenderObj->p_btCollisionObject);
+        checkpoint.bodies.push_back({body->getWorldTransform(), body->getLinearVelocity(), body->getAngularVelocity(), body->getGravity()});
+    }
+    checkpoint.landers.clear();
+    for(int i = 0; i < p_landerFleet->size(); i++)
+        checkpoint.landers.push_back(p_landerFleet->get(i)->saveCheckpoint());
+}
+
+void WorldPhysics::restoreCheckpoint(const SimCheckpoint& checkpoint){
+    if(checkpoint.bodies.size() != p_collisionObjects->size() || checkpoint.landers.size() != p_landerFleet->size())
+        throw std::runtime_error("Checkpoint does not match the loaded scene");
+
+    systemTimeStamp = checkpoint.systemTimeStamp;
+    simStepCount = checkpoint.simStepCount;
+    pendingSubSteps = checkpoint.pendingSubSteps;
+
+    //speed and clock mode are user settings, not sim state
+    WorldStats current = worldStats;
+    worldStats = checkpoint.worldStats;
+    worldStats.timeStepMultiplier = current.timeStepMultiplier;
+    worldStats.simClock = current.simClock;
+    worldStats.maxThroughput = current.maxThroughput;
+    resetRealTimeFactor();
+
+    for(int i = 0; i < p_collisionObjects->size(); i++){
+        CollisionRenderObj* collisionRenderObj = p_collisionObjects->at(i).get();
+        btRigidBody* body = btRigidBody::upcast(collisionRenderObj->p_btCollisionObject);
+        const RigidBodyCheckpoint& saved = checkpoint.bodies[i];
+
+        body->setWorldTransform(saved.transform);
+        body->setInterpolationWorldTransform(saved.transform);
+        if(body->getMotionState())
+            body->getMotionState()->setWorldTransform(saved.transform);
+        body->setLinearVelocity(saved.linearVelocity);
+        body->setAngularVelocity(saved.angularVelocity);
+        body->setInterpolationLinearVelocity(saved.linearVelocity);
+        body->setInterpolationAngularVelocity(saved.angularVelocity);
+        body->setGravity(saved.gravity);
+        body->clearForces();
+
+        //drop cached contacts, their warm starting impulses belong to the timeline we are leaving
+        p_dynamicsWorld->getBroadphase()->getOverlappingPairCache()->cleanProxyFromPairs(body->getBroadphaseHandle(), p_dynamicsWorld->getDispatcher());
+
+        updateObjectTransform(collisionRenderObj);
+    }
+    p_dynamicsWorld->updateAabbs(); //keep raycasts correct before the next step
+    if(replayRecorder)
+        replayRecorder->setTime(systemTimeStamp);
+
+    for(int i = 0; i < p_landerFleet->size(); i++)
+        p_landerFleet->get(i)->restoreCheckpoint(checkpoint.landers[i]);
+    r_mediator.scene_getLandingSiteObject()->updateLandingSiteObjects();
+    r_mediator.scene_getLanderObject()->updateSpotlight();
+}
+
+void WorldPhysics::quickSave(){
+    if(!quickSaveSlot)
+        quickSaveSlot = std::make_unique<SimCheckpoint>();
+    saveCheckpoint(*quickSaveSlot);
+    std::cout << "Checkpoint saved at " << systemTimeStamp << "s\n";
+}
+
+void WorldPhysics::quickLoad(){
+    if(!quickSaveSlot){
+        std::cout << "No checkpoint to restore\n";
+        return;
+    }
+    restoreCheckpoint(*quickSaveSlot);
+    std::cout << "Checkpoint restored to " << systemTimeStamp << "s\n";
+}
+
+void WorldPhysics::startRecording(const std::string& path, const SceneData& sceneData){
+    replayRecorder = std::make_unique<ReplayRecorder>();
+    if(!replayRecorder->open(path, sceneData, p_collisionObjects->size())){
+        replayRecorder.reset();
+        return;
+    }
+    replayRecorder->setTime(systemTimeStamp);
+}
+
+void WorldPhysics::stopRecording(){
+    replayRecorder.reset();
+}
+
+void WorldPhysics::recordBoost(const glm::vec3& vector){
+    if(replayRecorder)
+        replayRecorder->recordBoost(vector);
+}
+
+void WorldPhysics::startReplay(std::unique_ptr<ReplayPlayer> player){
+    stopRecording();
+    replayPlayer = std::move(player);
+    systemTimeStamp = replayPlayer->getTime();
+    updateDeltaTime(); //scene loading shouldnt count as playback time
+    resetRealTimeFactor();
+}
+
+//bullet and the lander cpu are left idle, the renderer only sees the poses the player writes into the collision objects
+void WorldPhysics::stepReplay(){
+    if(worldStats.timeStepMultiplier == 0 || replayPlayer->isFinished())
+        return;
+    replayPlayer->advance(deltaTime*worldStats.timeStepMultiplier, *p_collisionObjects, *r_mediator.scene_getLandingSiteObject(), r_mediator);
+    systemTimeStamp = replayPlayer->getTime();
+    if(replayPlayer->isFinished())
+        std::cout << "Replay finished at " << systemTimeStamp << "s\n";
+}
+
 void WorldPhysics::checkCollisions(){
     //check for collisions active and do something (start a timer, compare velocities over time, if minimal motion then end sim state)
     //get number of overlapping manifolds and iterate over them
@@ -80,9 +471,18 @@ void WorldPhysics::checkCollisions(){
                 if(worldStats.lastImpactForce > worldStats.largestImpactForce)
                     worldStats.largestImpactForce = worldStats.lastImpactForce;
 
-                if (totalImpact > 0.0000001f){
-                    std::cout << "Lander Contact\n";
-                    r_mediator.physics_landerCollided();
+                //mark whichever landers are in the contact, a lander to lander contact counts for both
+                const btCollisionObject* bodies[2] = {contactManifold->getBody0(), contactManifold->getBody1()};
+                for(const btCollisionObject* body : bodies){
+                    int slot = p_landerFleet->findSlot(body);
+                    if(slot < 0)
+                        continue;
+                    LanderObj* lander = p_landerFleet->get(slot);
+                    lander->largestImpactForce = std::max(lander->largestImpactForce, (float)totalImpact);
+                    if (totalImpact > 0.0000001f){
+                        std::cout << "Lander Contact\n";
+                        r_mediator.physics_landerCollided(slot);
+                    }
                 }
 
             }
@@ -109,43 +509,180 @@ glm::vec3 WorldPhysics::performRayCast(glm::vec3 from, glm::vec3 dir, float rang
     return hitpoint;
 }
 
+void AsteroidRayFrame::cast(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range, int threads) const{
+    TRACE_ZONE("AsteroidRayFrame::cast");
+    size_t count = std::min(origins.size(), dirs.size());
+    hits.assign(count, RayCastHit{});
+    if(count == 0 || !bvh || bvh->empty())
+        return;
+
+    //rays are moved into the asteroid's unscaled model space, the direction isnt renormalised so t stays in world units
+    glm::mat3 worldToModel = glm::transpose(rotation);
+    size_t chunks = (count + RAY_BATCH_CHUNK - 1)/RAY_BATCH_CHUNK;
+    std::atomic<size_t> nextChunk = 0;
+
+    //each chunk writes only its own hits, the bvh is read only
+    std::function<void()> worker = [&](){
+        for(size_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++){
+            size_t end = std::min(count, (chunk + 1)*RAY_BATCH_CHUNK);
+            for(size_t i = chunk*RAY_BATCH_CHUNK; i < end; i++){
+                glm::vec3 originModel = worldToModel*(origins[i] - translation)*invScale;
+                glm::vec3 dirModel = worldToModel*dirs[i]*invScale;
+                Service::RayHit rayHit;
+                if(!bvh->intersect(originModel, dirModel, 0.0f, range, rayHit))
+                    continue;
+                RayCastHit& hit = hits[i];
+                hit.hit = true;
+                hit.point = origins[i] + dirs[i]*rayHit.t;
+                hit.normal = glm::normalize(rotation*(bvh->getNormal(rayHit)*invScale)); //inverse transpose of rotation*scale
+                hit.fraction = rayHit.t/range;
+            }
+        }
+    };
+
+    size_t threadCount = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, chunks);
+    Service::WorkerPool::shared().parallel(threadCount, worker); //calling thread takes chunks too
+}
+
+AsteroidRayFrame WorldPhysics::getAsteroidRayFrame(){
+    AsteroidRayFrame frame;
+    if(p_asteroid == nullptr)
+        return frame;
+    if(!asteroidBvh){
+        asteroidBvh = std::make_shared<Service::MeshBvh>();
+        asteroidBvh->build(r_mediator.renderer_getAllVertices(), r_mediator.renderer_getAllIndices(), p_asteroid->indexBase, p_asteroid->indexCount);
+    }
+    const btTransform& transform = p_asteroid->p_btCollisionObject->getWorldTransform();
+    const btMatrix3x3& basis = transform.getBasis();
+    frame.bvh = asteroidBvh;
+    frame.rotation = glm::mat3(Service::bt2glm(basis.getColumn(0)), Service::bt2glm(basis.getColumn(1)), Service::bt2glm(basis.getColumn(2)));
+    frame.translation = Service::bt2glm(transform.getOrigin());
+    frame.invScale = 1.0f/p_asteroid->scale;
+    return frame;
+}
+
+void WorldPhysics::performRayCasts(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range){
+    getAsteroidRayFrame().cast(origins, dirs, hits, range, rayCastThreads);
+}
+
 //needs a semaphore or sync protection
 WorldStats& WorldPhysics::getWorldStats(){
     return worldStats;
 }
 
 void WorldPhysics::mainLoop(){
-    updateDeltaTime();
-    worldTick();
+    updateDeltaTime(); //keep lastTime current so switching back to WallClock doesnt produce one huge frame
+    if(replayPlayer)
+        stepReplay();
+    else if(worldStats.maxThroughput){
+        if(worldStats.timeStepMultiplier != 0) //if we are not paused
+            stepMaxThroughput();
+    }
+    else if(clockMode == ClockMode::SimClock){
+        if(worldStats.timeStepMultiplier != 0){ //if we are not paused
+            pendingSubSteps += SIM_CLOCK_SUBSTEPS_PER_CALL*worldStats.timeStepMultiplier;
+            int numSubSteps = (int)pendingSubSteps;
+            pendingSubSteps -= numSubSteps;
+            stepFixed(numSubSteps);
+        }
+    }
+    else
+        worldTick();
+    updateRealTimeFactor();
 }
 
 //callback method for pre simulation step
 void WorldPhysics::stepPreTickCallback(btDynamicsWorld *world, btScalar timeStep){
+    TRACE_ZONE("WorldPhysics::stepPreTickCallback");
     WorldPhysics* p_physics = (WorldPhysics*)world->getWorldUserInfo();
     p_physics->updateCollisionObjects(timeStep);
     p_physics->r_mediator.scene_getLandingSiteObject()->updateLandingSiteObjects();
     p_physics->r_mediator.scene_getLanderObject()->updateSpotlight();
+    if(p_physics->replayRecorder)
+        p_physics->replayRecorder->recordFrame(*p_physics->p_collisionObjects, *p_physics->r_mediator.scene_getLandingSiteObject());
 }
 
 //callback method for post simulation step
 void WorldPhysics::stepPostTickCallback(btDynamicsWorld *world, btScalar timeStep){
+    TRACE_ZONE("WorldPhysics::stepPostTickCallback");
     WorldPhysics* p_physics = (WorldPhysics*)world->getWorldUserInfo();
     p_physics->checkCollisions();
+    if(p_physics->replayRecorder)
+        p_physics->replayRecorder->advanceTime(timeStep);
 }
 
 //initialize bullet physics engine
+int WorldPhysics::bulletWorkers = 0;
+
+void WorldPhysics::setBulletThreading(int workers, TaskSchedulerType type){
+#ifdef LS_BULLET_MT
+    if(workers <= 0){
+        bulletWorkers = 0;
+        return;
+    }
+    btITaskScheduler* scheduler = nullptr;
+    switch(type){
+        case TaskSchedulerType::OpenMP: scheduler = btGetOpenMPTaskScheduler(); break;
+        case TaskSchedulerType::TBB: scheduler = btGetTBBTaskScheduler(); break;
+        case TaskSchedulerType::PPL: scheduler = btGetPPLTaskScheduler(); break;
+        default: break;
+    }
+    if(!scheduler && type != TaskSchedulerType::Default)
+        std::cout << "Requested task scheduler isnt built into bullet, using the default\n";
+    if(!scheduler){
+        static std::unique_ptr<btITaskScheduler> defaultScheduler(btCreateDefaultTaskScheduler()); //threads are started once and reused by every world
+        scheduler = defaultScheduler.get();
+    }
+    if(!scheduler){
+        std::cout << "Bullet was built without BT_THREADSAFE, physics stays single threaded\n";
+        bulletWorkers = 0;
+        return;
+    }
+    setTaskScheduler(scheduler, workers);
+#else
+    if(workers > 0)
+        std::cout << "Built without LS_BULLET_MT, physics stays single threaded\n";
+#endif
+}
+
+void WorldPhysics::setTaskScheduler(btITaskScheduler* scheduler, int workers){
+#ifdef LS_BULLET_MT
+    if(!scheduler || workers <= 0){
+        bulletWorkers = 0;
+        return;
+    }
+    scheduler->setNumThreads(std::min(workers, scheduler->getMaxNumThreads()));
+    btSetTaskScheduler(scheduler);
+    bulletWorkers = scheduler->getNumThreads();
+#else
+    if(workers > 0)
+        std::cout << "Built without LS_BULLET_MT, physics stays single threaded\n";
+#endif
+}
+
 void WorldPhysics::initBullet(){
     ///collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
     collisionConfiguration = new btDefaultCollisionConfiguration();
-    dispatcher = new btCollisionDispatcher(collisionConfiguration);
-    btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
     overlappingPairCache = new btDbvtBroadphase();
     //overlappingPairCache = new btSimpleBroadphase();
-    //the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-    solver = new btSequentialImpulseConstraintSolver();
-    //dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
 
-    p_dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
+#ifdef LS_BULLET_MT
+    if(bulletWorkers > 0){
+        //narrowphase pairs, islands and large island constraint rows are split across the task scheduler's threads
+        dispatcher = new btCollisionDispatcherMt(collisionConfiguration, MT_DISPATCH_GRAIN_SIZE);
+        btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+        solverPool = new btConstraintSolverPoolMt(bulletWorkers);
+        solver = new btSequentialImpulseConstraintSolverMt();
+        p_dynamicsWorld = new btDiscreteDynamicsWorldMt(dispatcher, overlappingPairCache, solverPool, solver, collisionConfiguration);
+    }
+#endif
+    if(!p_dynamicsWorld){
+        dispatcher = new btCollisionDispatcher(collisionConfiguration);
+        btGImpactCollisionAlgorithm::registerAlgorithm(dispatcher);
+        solver = new btSequentialImpulseConstraintSolver();
+        p_dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
+    }
     p_dynamicsWorld->setGravity(btVector3(0, 0, 0));
     p_dynamicsWorld->setInternalTickCallback(stepPreTickCallback, this, true);
     p_dynamicsWorld->setInternalTickCallback(stepPostTickCallback, this, false);
@@ -156,14 +693,18 @@ void WorldPhysics::initBullet(){
 //void WorldPhysics::loadCollisionFile(){ 
 //}
 
-void WorldPhysics::loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects){ 
+void WorldPhysics::loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects, Lander::Fleet* landerFleet){ 
     p_collisionObjects = collisionObjects;
+    p_landerFleet = landerFleet;
     collisionShapes.clear();
     int i = 0;
     for (std::shared_ptr<CollisionRenderObj> obj : *p_collisionObjects){
         obj->init(&collisionShapes, p_dynamicsWorld, r_mediator);
         obj->p_btCollisionObject = p_dynamicsWorld->getCollisionObjectArray()[i++];  //add the btCollisionObject pointer to the object, se we can iterate through this to better link the objects
+        if(dynamic_cast<AsteroidObj*>(obj.get()))
+            p_asteroid = obj.get();
     }
+    p_landerFleet->bindBodies();
 }
 
 void WorldPhysics::changeSimSpeed(int direction, bool pause){
@@ -174,6 +715,8 @@ void WorldPhysics::changeSimSpeed(int direction, bool pause){
             setSimSpeedMultiplier(0);
     }
     else{
+        if(worldStats.maxThroughput)
+            toggleMaxThroughput(); //picking a speed leaves max throughput
         if(direction == 0) //0 will be a normal speed shortcut eventually?
             selectedSimSpeedIndex = 2;
         else{
@@ -201,6 +744,17 @@ void WorldPhysics::reset(){
     //changeSimSpeed(0, false); //pause and sim speed should be seperated
     selectedSimSpeedIndex = 2;
     setSimSpeedMultiplier(SIM_SPEEDS[selectedSimSpeedIndex]);
+    systemTimeStamp = 0;
+    simStepCount = 0;
+    pendingSubSteps = 0;
+    quickSaveSlot.reset(); //belongs to the old scene
+    p_asteroid = nullptr;
+    asteroidBvh.reset(); //frames still held by sensors keep their copy
+    stopRecording();
+    replayPlayer.reset();
+    if(worldStats.maxThroughput)
+        toggleMaxThroughput();
+    resetRealTimeFactor();
     //cleanup in the reverse order of creation/initialization
 	///-----cleanup_start-----
 	//remove the rigidbodies from the dynamics world and delete them
@@ -226,6 +780,9 @@ void WorldPhysics::cleanupBullet(){
     reset();
 	delete p_dynamicsWorld;
 	delete solver;
+#ifdef LS_BULLET_MT
+	delete solverPool; //the Mt world doesnt own its solver pool
+#endif
 	//delete broadphase
 	delete overlappingPairCache;
 	delete dispatcher;
@@ -13,27 +13,91 @@
 #include <deque>
 #include <mutex>
 #include <limits> //get float max value for infinite raycast default
+#include <cstdint>
+#include <string>
+#include "sv_meshBvh.h"
 
 namespace Vk{
     class Renderer; //forward reference, because we reference this before defining it
 }
 
 class Mesh; //forward reference, because we reference this before defining it
+struct SimCheckpoint; //defined in dmn_checkpoint.h
+struct SceneData;
+class ReplayRecorder; //defined in dmn_replay.h
+class ReplayPlayer;
 class WorldInput;
+struct BenchmarkAccess; //benchmarks/ times private per tick work directly
 class Mediator;
 
+namespace Lander{
+    class Fleet;
+}
+
+class btITaskScheduler;
+
+//one ray of WorldPhysics::performRayCasts, world space, normal is the interpolated surface normal at the hit
+//fraction is the hit distance over the ray range, 1 on a miss like bullet's ClosestRayResultCallback
+struct RayCastHit{
+    bool hit = false;
+    glm::vec3 point = glm::vec3(0);
+    glm::vec3 normal = glm::vec3(0);
+    float fraction = 1.0f;
+};
+
+//the asteroid's bvh and pose at the substep it was taken, casts against it can run on any thread while physics keeps stepping
+//the frame shares ownership of the bvh, so it stays valid across a scene reset
+struct AsteroidRayFrame{
+    static const size_t RAY_BATCH_CHUNK = 64; //rays per task, a batch smaller than this runs on the calling thread
+
+    std::shared_ptr<const Service::MeshBvh> bvh; //null if the scene has no asteroid
+    glm::mat3 rotation = glm::mat3(1.0f);
+    glm::vec3 translation = glm::vec3(0);
+    glm::vec3 invScale = glm::vec3(1.0f);
+
+    //threads 0 uses hardware_concurrency, chunks of rays are handed out from a shared counter to the calling thread and Service::WorkerPool
+    void cast(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range, int threads) const;
+};
+class btConstraintSolverPoolMt;
+
 class WorldPhysics{
+    friend struct ::BenchmarkAccess;
 public:
+    //WallClock steps by real frame time (interactive default)
+    //SimClock steps a fixed number of FIXED_TIME_STEP substeps per call, independent of rendering, so runs are reproducible
+    enum class ClockMode{WallClock, SimClock};
+
+    //multithreaded bullet, needs a bullet built with BT_THREADSAFE and LS_BULLET_MT set in cmake, otherwise worlds stay single threaded
+    //bullet has one task scheduler per process, so set it before creating any WorldPhysics, worlds already created keep their type
+    //workers 0 builds a plain btDiscreteDynamicsWorld, >0 a btDiscreteDynamicsWorldMt with that many task scheduler threads
+    //only one thread may step the Mt worlds, so leave it off when several worlds are stepped in parallel (campaigns)
+    enum class TaskSchedulerType{Default, OpenMP, TBB, PPL};
+    static void setBulletThreading(int workers, TaskSchedulerType type = TaskSchedulerType::Default);
+    static void setTaskScheduler(btITaskScheduler* scheduler, int workers); //plug in any scheduler, the caller keeps ownership
+    static int getBulletWorkers(){return bulletWorkers;};
+
     WorldStats worldStats;
 
     WorldStats& getWorldStats();
     void setSimSpeedMultiplier(float multiplier);
-    void loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects); //load bullet collision meshes, 
+    void loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects, Lander::Fleet* landerFleet); //load bullet collision meshes, 
     
     double deltaTime = 0.0; // Time between current frame and last frame
     std::chrono::_V2::system_clock::time_point lastTime{}; // Time of last frame
     void updateDeltaTime();
     void worldTick();
+    void stepFixed(int numSubSteps); //advance exactly numSubSteps of FIXED_TIME_STEP
+    //FIXED_TIME_STEP substeps the next step will cover, far field or adaptive, 1 near the surface
+    //callers stepping frame by frame can pass this to stepFixed so a long step isnt cut short
+    int getNextStepSubSteps();
+    void setClockMode(ClockMode mode);
+    void toggleClockMode();
+    ClockMode getClockMode(){return clockMode;};
+
+    //uncapped time warp, runs SimClock substeps back to back until the frame's wall time budget is spent
+    //the main view is only redrawn every MAX_THROUGHPUT_RENDER_INTERVAL sim seconds, check isRenderDue before drawing
+    void toggleMaxThroughput();
+    bool isRenderDue();
 
     int getWorldObjectsCount();
 
@@ -50,38 +114,116 @@ public:
     static void stepPreTickCallback(btDynamicsWorld *world, btScalar timeStep);
     static void stepPostTickCallback(btDynamicsWorld *world, btScalar timeStep);
     glm::vec3 performRayCast(glm::vec3 from, glm::vec3 dir, float range = std::numeric_limits<float>::max());
+    //batched casts against the asteroid only, hits[i] is ray origins[i] + t*dirs[i], dirs should be normalised so fractions are of range
+    //traverses a 4 wide MeshBvh of the asteroid's triangles instead of the bullet world, so rays are split across threads safely
+    //small batches stay on the calling thread, call between steps
+    void performRayCasts(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range = std::numeric_limits<float>::max());
+    AsteroidRayFrame getAsteroidRayFrame(); //for casting off the physics thread, call between steps
+    void setRayCastThreads(int n){rayCastThreads = n;}; //0 uses hardware_concurrency
 
     double getTimeStamp(){return systemTimeStamp;};
 
+    //checkpoints, only call between steps
+    void saveCheckpoint(SimCheckpoint& checkpoint);
+    void restoreCheckpoint(const SimCheckpoint& checkpoint);
+    void quickSave(); //keeps one checkpoint in memory, dropped on reset
+    void quickLoad();
+
+    //replays, recording writes the render pose of every body each substep, call after the scene is loaded, stopped on reset
+    //while a replay is playing mainLoop moves the bodies from the file instead of stepping bullet and the lander cpu
+    //speed and pause still apply to playback
+    void startRecording(const std::string& path, const SceneData& sceneData);
+    void stopRecording();
+    void recordBoost(const glm::vec3& vector); //thrust event for the replay, no-op when not recording
+    void startReplay(std::unique_ptr<ReplayPlayer> player);
+    bool isReplaying(){return replayPlayer != nullptr;};
+
+    static constexpr float FIXED_TIME_STEP = 0.01666666754F/2; //physics substep, 1/120s, lander cpu timers count whole substeps of it
+    const int SIM_CLOCK_SUBSTEPS_PER_CALL = 2; //substeps per mainLoop in SimClock mode at 1x, one 60fps frame
+    const double MAX_THROUGHPUT_FRAME_BUDGET = 0.03; //wall seconds of stepping per mainLoop, events are polled between batches
+    const double MAX_THROUGHPUT_RENDER_INTERVAL = 10.0; //sim seconds between main view redraws
+    const double MAX_THROUGHPUT_RENDER_GAP = 0.25; //wall seconds, redraw at least this often so the ui stays usable at low throughput
+    const double RTF_SAMPLE_SECONDS = 1.0; //wall seconds the real time factor is averaged over
+
+    //far field propagation, on the fixed step clock the landers are integrated outside bullet while they are far from everything
+    //steps end just before any lander cpu timer fires, so gnc and imaging still run on the substep they would under bullet
+    //every lander has to be clear for a far field step, landers only need to stay ADAPTIVE_FINE_CLEARANCE apart from each other
+    const bool FAR_FIELD_PROPAGATION = true;
+    const float FAR_FIELD_CLEARANCE = 50.0f; //bounding sphere gap to the nearest body that isnt a lander, below this bullet steps the landers
+    const int FAR_FIELD_MAX_SUBSTEPS = 24; //longest far field step, 0.2s
+
+    //adaptive step, inside the far field clearance bullet steps a whole number of FIXED_TIME_STEP substeps at once
+    //the step shrinks as any lander closes on its nearest body and is FIXED_TIME_STEP near the surface or while a lander touches anything
+    //like far field steps they end before a lander cpu timer fires, and the timestamp stays a whole number of substeps
+    const bool ADAPTIVE_TIME_STEP = true;
+    const float ADAPTIVE_FINE_CLEARANCE = 5.0f; //below this every substep is stepped
+    const float ADAPTIVE_MAX_CLOSING_FRACTION = 0.1f; //a step may close at most this fraction of the clearance
+    const int ADAPTIVE_MAX_SUBSTEPS = 8; //longest bullet step, 1/15s
+
 private:
    
     double systemTimeStamp = 0; //tracked for file writing purposes
+    ClockMode clockMode = ClockMode::WallClock;
+    uint64_t simStepCount = 0; //substeps taken in SimClock mode, timestamp is derived from this so it doesnt drift
+    float pendingSubSteps = 0; //fractional substeps carried over between SimClock calls at speeds below 1x
+    float wallClockSubStep = FIXED_TIME_STEP; //bullet substep of the last WallClock frame, its leftover time is less than this
+    ClockMode clockModeBeforeMaxThroughput = ClockMode::WallClock;
+    double lastRenderSimTime = 0;
+    std::chrono::_V2::system_clock::time_point lastRenderTime{};
+    double rtfSampleSimTime = 0;
+    std::chrono::_V2::system_clock::time_point rtfSampleTime{};
     int selectedSimSpeedIndex = 2;
     float SIM_SPEEDS[9] {0.25f,0.5f,1,2,4,8,16,32,64};
     int SPEED_ARRAY_SIZE = *(&SIM_SPEEDS + 1) - SIM_SPEEDS - 1; //get length of array (-1 because we want the last element) (https://www.educative.io/edpresso/how-to-find-the-length-of-an-array-in-cpp)
     
     //Bullet vars
     Mediator& r_mediator;
-    btDiscreteDynamicsWorld* p_dynamicsWorld;
+    btDiscreteDynamicsWorld* p_dynamicsWorld = nullptr;
     //MyDynamicsWorld* p_dynamicsWorld;
     btBroadphaseInterface* overlappingPairCache;
-    ///the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-    btSequentialImpulseConstraintSolver* solver;
+    //btSequentialImpulseConstraintSolver, or btSequentialImpulseConstraintSolverMt for large islands in a multithreaded world
+    btConstraintSolver* solver;
+    btConstraintSolverPoolMt* solverPool = nullptr; //one solver per thread for small islands, only in a multithreaded world
     btCollisionDispatcher* dispatcher;
     btDefaultCollisionConfiguration* collisionConfiguration;
     //keep track of the shapes, we release memory at exit.
 	//make sure to re-use collision shapes among rigid bodies whenever possible!
 	btAlignedObjectArray<btCollisionShape*> collisionShapes;
 
-    std::vector<std::shared_ptr<CollisionRenderObj>>* p_collisionObjects;
+    std::vector<std::shared_ptr<CollisionRenderObj>>* p_collisionObjects = nullptr;
+    Lander::Fleet* p_landerFleet = nullptr;
 
     void initLights();
     void initBullet();
     void cleanupBullet();   
 
+    //batched ray casts, the bvh is built from the asteroid's render mesh on the first batch after a scene load
+    CollisionRenderObj* p_asteroid = nullptr;
+    std::shared_ptr<Service::MeshBvh> asteroidBvh;
+    int rayCastThreads = 0;
+
+    static int bulletWorkers; //0 unless a task scheduler was set, see setBulletThreading
+    const int MT_DISPATCH_GRAIN_SIZE = 40; //overlapping pairs per narrowphase task, bullet's own default
+
     int SUBSTEP_SAFETY_MARGIN = 1; //need to redo timestep code completely
 
+    std::unique_ptr<SimCheckpoint> quickSaveSlot;
+    std::unique_ptr<ReplayRecorder> replayRecorder;
+    std::unique_ptr<ReplayPlayer> replayPlayer;
+
+    void stepMaxThroughput();
+    void stepReplay();
+    void propagateFarField(int numSubSteps);
+    int getFarFieldSubSteps(); //0 if bullet has to step the landers
+    int getAdaptiveSubSteps();
+    int getAdaptiveSubSteps(int landerSlot);
+    int limitToNextTimer(int numSubSteps); //cut a step so it ends the substep before any lander cpu timer or lidar scan fires
+    float getClearance(btRigidBody* body, float* closingSpeed = nullptr, bool includeLanders = true);
+    bool isInContact(btCollisionObject* object);
+    void updateRealTimeFactor();
+    void resetRealTimeFactor();
     void updateCollisionObjects(float timeStep);
+    void updateObjectTransform(CollisionRenderObj* collisionRenderObj);
     void checkCollisions();
 
     glm::mat4 rotateAround(glm::vec3 aPointToRotate, glm::vec3 aRotationCenter, glm::mat4 aRotationMatrix );
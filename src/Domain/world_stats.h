@@ -6,5 +6,10 @@ struct WorldStats{
         float landerVelocity = 0;
         float lastImpactForce = 0;
         float largestImpactForce = 0;
+        bool simClock = false; //true if physics is on the deterministic fixed step clock
+        bool maxThroughput = false; //true while time warp is uncapped
+        bool farField = false; //true while the lander is propagated outside bullet
+        float physicsStep = 0; //seconds covered by the last physics step, FIXED_TIME_STEP near the surface
+        float realTimeFactor = 0; //sim seconds per wall second, measured over the last RTF_SAMPLE_SECONDS
         glm::vec3 estimatedAngularVelocity = glm::vec3(0); //here to save time, for output on ui
 };
\ No newline at end of file
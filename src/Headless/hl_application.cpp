@@ -0,0 +1,153 @@
+#include "hl_application.h"
+#include "obj_lander.h"
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+Headless::Application::~Application(){
+    if(scene)
+        endScene();
+}
+
+Headless::RunResult Headless::Application::run(SceneData sceneData, double maxSimSeconds){
+    beginRun(sceneData);
+    LanderObj* p_lander = mediator.scene_getLanderObject();
+    Lander::Fleet* landerFleet = mediator.scene_getLanderFleet();
+
+    RunResult result;
+    result.seed = scene->getSceneData()->SEED;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    stepUntilFleetLanded(maxSimSeconds, result, p_lander, landerFleet);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result.wallSeconds = std::chrono::duration<double, std::chrono::seconds::period>(end - start).count();
+    if(result.wallSeconds > 0)
+        result.realTimeFactor = worldPhysics.getTimeStamp()/result.wallSeconds;
+
+    endScene();
+    return result;
+}
+
+bool Headless::Application::runToDescent(SceneData sceneData, double maxSimSeconds){
+    beginRun(sceneData);
+    LanderObj* p_lander = mediator.scene_getLanderObject();
+
+    stepUntil(maxSimSeconds, [&](){return p_lander->collided || p_lander->cpu.isDescending();});
+    if(!p_lander->cpu.isDescending() || p_lander->collided){
+        endScene();
+        return false;
+    }
+
+    descentCheckpoint = std::make_unique<SimCheckpoint>();
+    worldPhysics.saveCheckpoint(*descentCheckpoint);
+    return true;
+}
+
+Headless::RunResult Headless::Application::runFromCheckpoint(double maxSimSeconds, std::function<void(LanderObj*)> configure){
+    if(!scene || !descentCheckpoint)
+        throw std::runtime_error("runFromCheckpoint called without a descent checkpoint, call runToDescent first");
+
+    worldPhysics.restoreCheckpoint(*descentCheckpoint);
+    renderer.clearOpticsRequests(); //drop any optics request left over from the previous branch
+    LanderObj* p_lander = mediator.scene_getLanderObject();
+    Lander::Fleet* landerFleet = mediator.scene_getLanderFleet();
+    if(configure)
+        configure(p_lander);
+
+    RunResult result;
+    result.seed = scene->getSceneData()->SEED;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    stepUntilFleetLanded(maxSimSeconds, result, p_lander, landerFleet);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    //sim time includes the shared prefix so results line up with a full run, wall time only covers this branch
+    result.wallSeconds = std::chrono::duration<double, std::chrono::seconds::period>(end - start).count();
+    if(result.wallSeconds > 0)
+        result.realTimeFactor = (worldPhysics.getTimeStamp() - descentCheckpoint->systemTimeStamp)/result.wallSeconds;
+    return result;
+}
+
+void Headless::Application::endForks(){
+    descentCheckpoint.reset();
+    if(scene)
+        endScene();
+}
+
+void Headless::Application::beginRun(SceneData sceneData){
+    if(scene)
+        endForks(); //previous run was left loaded for forking
+
+    //associate components with mediator class, camera, ui and application are left null
+    mediator.setPhysicsEngine(&worldPhysics);
+    mediator.setRenderEngine(&renderer);
+
+    //sets up the file system for outputting experiment data
+    if(Service::OUTPUT_TEXT && writeOutput){
+        writer.clearOutputFolders();
+        writer.openFiles();
+        mediator.setWriter(&writer);
+    }
+
+    loadScene(sceneData);
+    Lander::Fleet* landerFleet = mediator.scene_getLanderFleet();
+    for(int i = 0; i < landerFleet->size(); i++)
+        landerFleet->get(i)->cpu.setSynchronousVision(true); //no detached threads outliving the run, and image processing stays in step with the sim clock
+
+    //step as fast as possible, no frame pacing, on the fixed step clock so runs are reproducible
+    worldPhysics.setClockMode(WorldPhysics::ClockMode::SimClock);
+}
+
+void Headless::Application::stepUntil(double maxSimSeconds, const std::function<bool()>& stop){
+    while(!stop() && worldPhysics.getTimeStamp() < maxSimSeconds){
+        worldPhysics.stepFixed(std::max(HEADLESS_SUBSTEPS_PER_FRAME, worldPhysics.getNextStepSubSteps())); //long steps stop before an optics request, so images are still drawn on time
+        renderer.drawFrame(); //optics image, if vision asked for one this frame
+    }
+}
+
+//results are the primary lander's, taken on the step it touches down, the rest of the fleet flies on until it lands too
+//if the primary never lands they are taken when the run times out
+void Headless::Application::stepUntilFleetLanded(double maxSimSeconds, RunResult& result, LanderObj* p_lander, Lander::Fleet* landerFleet){
+    bool collected = false;
+    stepUntil(maxSimSeconds, [&](){
+        if(!collected && p_lander->collided){
+            collectLandingMetrics(result, p_lander);
+            collected = true;
+        }
+        return landerFleet->allCollided();
+    });
+    if(!collected)
+        collectLandingMetrics(result, p_lander);
+}
+
+void Headless::Application::collectLandingMetrics(RunResult& result, LanderObj* p_lander){
+    result.simSeconds = worldPhysics.getTimeStamp();
+    result.landerCollided = p_lander->collided;
+    result.touchdownError = p_lander->cpu.getLandingSiteDistance();
+    result.peakImpactForce = p_lander->largestImpactForce;
+    result.totalDeltaV = p_lander->cpu.getTotalDeltaV();
+    result.hasSpinEstimate = p_lander->cpu.hasSpinEstimate();
+    if(result.hasSpinEstimate)
+        result.spinEstimateError = p_lander->cpu.getSpinEstimateError();
+}
+
+void Headless::Application::loadScene(SceneData sceneData){
+    scene = std::make_unique<MyScene>(mediator);
+    mediator.setScene(scene.get());
+    scene->initScene(sceneData);
+    if(Service::OUTPUT_TEXT && Service::OUTPUT_REPLAY && writeOutput)
+        worldPhysics.startRecording(writer.getOutPath() + "replay.lsrp", *scene->getSceneData());
+}
+
+void Headless::Application::endScene(){
+    mediator.renderer_resetScene();
+    mediator.physics_reset();
+    if(Service::OUTPUT_TEXT && writeOutput){
+        writer.closeFiles();
+    }
+    scene.reset();
+    mediator.setScene(nullptr);
+    descentCheckpoint.reset();
+}
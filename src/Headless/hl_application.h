@@ -0,0 +1,68 @@
+#pragma once
+#include <memory>
+#include <functional>
+#include "mediator.h"
+#include "world_physics.h"
+#include "data_scene.h"
+#include "dmn_myScene.h"
+#include "filewriter.h"
+#include "hl_renderer.h"
+#include "dmn_checkpoint.h"
+
+namespace Headless{
+
+//results of a single headless run, printed by main_headless and collected by batch runners
+struct RunResult{
+    double simSeconds = 0; //simulated time the primary lander touched down, or the run ended if it never did
+    double wallSeconds = 0; //real time taken to run it
+    double realTimeFactor = 0; //sim seconds stepped per wall second, the whole fleet is stepped so this can run past simSeconds
+    bool landerCollided = false; //false if the run hit maxSimSeconds first
+    uint64_t seed = 0; //scenario seed actually used, pass it back in SceneData.SEED to replay the run
+
+    //landing outcome, measured in process on the primary lander's touchdown step so campaigns dont need the text output
+    double touchdownError = 0; //m from the lander to the landing site surface point, only meaningful if landerCollided
+    double peakImpactForce = 0; //largest contact the primary lander was part of up to touchdown
+    double totalDeltaV = 0; //m/s summed over every translation boost
+    bool hasSpinEstimate = false; //false if the run used the true asteroid spin or stopped before estimation finished
+    double spinEstimateError = 0; //rad/s, length of estimated minus actual asteroid angular velocity
+};
+
+//drives WorldPhysics, MyScene and Lander::CPU with no window, swapchain or ImGui
+//physics is stepped back to back on the fixed step sim clock, so throughput is only bound by the cpu
+class Application{
+    public:
+        Application(){};
+        Application(const std::string& outputPath): writer{outputPath}{}; //outputPath should end with a /
+        ~Application();
+        RunResult run(SceneData sceneData, double maxSimSeconds);
+
+        //forking, run the shared estimation prefix once then branch any number of descents from it
+        //runToDescent leaves the scene loaded and returns false if the lander collided or timed out before descent started
+        //each runFromCheckpoint restores the descent checkpoint, configure can change the lander (eg controller params) before stepping
+        //call endForks when done, or let the destructor do it
+        bool runToDescent(SceneData sceneData, double maxSimSeconds);
+        RunResult runFromCheckpoint(double maxSimSeconds, std::function<void(LanderObj*)> configure = nullptr);
+        void endForks();
+        double getCheckpointTime(){return descentCheckpoint ? descentCheckpoint->systemTimeStamp : 0;};
+        void setOpticsThreads(int n){renderer.setOpticsThreads(n);}; //threads used to ray cast each optics image, 0 uses hardware_concurrency
+        void setWriteOutput(bool b){writeOutput = b;}; //false skips the writer entirely, no text, run log or images, RunResult is still filled
+    private:
+        //substeps per loop iteration, one 60fps interactive frame so impact force stats (impulse*deltaTime) stay comparable
+        const int HEADLESS_SUBSTEPS_PER_FRAME = 2;
+
+        Mediator mediator = Mediator();
+        WorldPhysics worldPhysics = WorldPhysics(mediator);
+        Headless::Renderer renderer;
+        Service::Writer writer;
+        std::unique_ptr<MyScene> scene;
+        std::unique_ptr<SimCheckpoint> descentCheckpoint;
+        bool writeOutput = true;
+
+        void beginRun(SceneData sceneData);
+        void stepUntil(double maxSimSeconds, const std::function<bool()>& stop);
+        void stepUntilFleetLanded(double maxSimSeconds, RunResult& result, LanderObj* p_lander, Lander::Fleet* landerFleet);
+        void collectLandingMetrics(RunResult& result, LanderObj* p_lander);
+        void loadScene(SceneData sceneData);
+        void endScene();
+};
+}
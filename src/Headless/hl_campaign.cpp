@@ -0,0 +1,155 @@
+#include "hl_campaign.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include "sv_trace.h"
+
+void Headless::CampaignStats::add(const CampaignRunResult& runResult){
+    runs++;
+    if(runResult.failed){
+        failed++;
+        return;
+    }
+    const RunResult& result = runResult.result;
+    totalSimSeconds += result.simSeconds;
+    totalRunWallSeconds += result.wallSeconds;
+    if(result.hasSpinEstimate)
+        spinEstimateError.add(result.spinEstimateError);
+    if(!result.landerCollided)
+        return;
+    landed++;
+    touchdownError.add(result.touchdownError);
+    peakImpactForce.add(result.peakImpactForce);
+    totalDeltaV.add(result.totalDeltaV);
+    timeToTouchdown.add(result.simSeconds);
+}
+
+void Headless::CampaignStats::merge(const CampaignStats& other){
+    runs += other.runs;
+    landed += other.landed;
+    failed += other.failed;
+    totalSimSeconds += other.totalSimSeconds;
+    totalRunWallSeconds += other.totalRunWallSeconds;
+    touchdownError.merge(other.touchdownError);
+    peakImpactForce.merge(other.peakImpactForce);
+    totalDeltaV.merge(other.totalDeltaV);
+    spinEstimateError.merge(other.spinEstimateError);
+    timeToTouchdown.merge(other.timeToTouchdown);
+}
+
+Headless::Campaign::Campaign(int workers, const std::string& root): numWorkers{workers}, outputRoot{root}{
+    if(numWorkers <= 0)
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::vector<Headless::CampaignRunResult> Headless::Campaign::run(const std::vector<SceneData>& variants, double maxSimSeconds){
+    std::vector<CampaignRunResult> results(variants.size());
+    std::atomic<size_t> nextRun = 0;
+
+    try{
+        std::filesystem::remove_all(outputRoot);
+        std::filesystem::create_directories(outputRoot);
+    }
+    catch (const std::exception &e){
+        std::cerr << e.what() << std::endl;
+    }
+
+    //runs are already parallel, split the cores between each run's optics ray casting
+    int opticsThreads = std::max<int>(1, std::thread::hardware_concurrency()/std::max(1, std::min<int>(numWorkers, variants.size())));
+
+    int threadCount = std::min<size_t>(numWorkers, variants.size());
+
+    //each worker owns nothing between runs, every run builds and tears down its own world
+    //stats are kept per worker and merged after the join, so finishing a run never waits on another worker
+    std::vector<CampaignStats> workerStats(threadCount);
+    std::atomic<int> nextWorkerId = 0;
+    auto worker = [&](){
+        int workerId = nextWorkerId++;
+        if(Service::Tracer::get().isEnabled()) //naming allocates the thread's buffer, skip it when not tracing
+            Service::Tracer::get().setThreadName("campaign worker " + std::to_string(workerId));
+        for(size_t i = nextRun++; i < variants.size(); i = nextRun++){
+            CampaignRunResult& runResult = results[i];
+            runResult.runIndex = i;
+            runResult.outputPath = outputRoot + "run_" + std::to_string(i) + "/";
+            try{
+                Headless::Application app = Headless::Application(runResult.outputPath);
+                app.setOpticsThreads(opticsThreads);
+                app.setWriteOutput(runOutput);
+                runResult.result = app.run(variants[i], maxSimSeconds);
+            }
+            catch (const std::exception &e){
+                runResult.failed = true;
+                runResult.error = e.what();
+            }
+            workerStats[workerId].add(runResult);
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < threadCount; t++)
+        threads.emplace_back(worker);
+    for(std::thread& thread : threads)
+        thread.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    wallSeconds = std::chrono::duration<double, std::chrono::seconds::period>(end - start).count();
+
+    stats = CampaignStats();
+    for(const CampaignStats& s : workerStats)
+        stats.merge(s);
+    return results;
+}
+
+static void printMetric(const std::string& name, const Service::QuantileSketch& sketch){
+    std::cout << std::setw(24) << name << std::setw(8) << sketch.getCount();
+    if(sketch.getCount() > 0)
+        std::cout << std::setw(12) << sketch.getMean() << std::setw(12) << sketch.getMin() << std::setw(12) << sketch.quantile(0.5)
+                  << std::setw(12) << sketch.quantile(0.9) << std::setw(12) << sketch.quantile(0.99) << std::setw(12) << sketch.getMax();
+    if(sketch.getNonFiniteCount() > 0)
+        std::cout << "  (" << sketch.getNonFiniteCount() << " non finite left out)";
+    std::cout << "\n";
+}
+
+void Headless::Campaign::printSummary(const std::vector<CampaignRunResult>& results){
+    bool listAll = results.size() <= MAX_SUMMARY_ROWS;
+
+    std::cout << "----------------------------------------------------\n";
+    std::cout << "Campaign summary, " << results.size() << " runs on " << numWorkers << " workers\n";
+    if(!listAll)
+        std::cout << "Only failed runs are listed for campaigns over " << MAX_SUMMARY_ROWS << " runs\n";
+    std::cout << std::setw(6) << "run" << std::setw(22) << "seed" << std::setw(14) << "sim(s)" << std::setw(14) << "wall(s)" << std::setw(14) << "rtf" << std::setw(10) << "landed" << "\n";
+    for(const CampaignRunResult& r : results){
+        if(r.failed){
+            std::cout << std::setw(6) << r.runIndex << "  failed: " << r.error << "\n";
+            continue;
+        }
+        if(!listAll)
+            continue;
+        std::cout << std::setw(6) << r.runIndex
+                  << std::setw(22) << r.result.seed
+                  << std::setw(14) << r.result.simSeconds
+                  << std::setw(14) << r.result.wallSeconds
+                  << std::setw(14) << r.result.realTimeFactor
+                  << std::setw(10) << r.result.landerCollided << "\n";
+    }
+    std::cout << "Landed: " << stats.landed << "/" << stats.runs << ", failed: " << stats.failed << "\n";
+    std::cout << "Total sim time: " << stats.totalSimSeconds << "s, summed run wall time: " << stats.totalRunWallSeconds << "s\n";
+    std::cout << "Campaign wall time: " << wallSeconds << "s\n";
+    if(wallSeconds > 0)
+        std::cout << "Campaign real time factor: " << stats.totalSimSeconds/wallSeconds << "x\n";
+
+    //quantiles are from the sketches, within 1% of a real sample
+    std::cout << std::setw(24) << "metric" << std::setw(8) << "n" << std::setw(12) << "mean" << std::setw(12) << "min" << std::setw(12) << "p50"
+              << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    printMetric("touchdown error (m)", stats.touchdownError);
+    printMetric("peak impact (N)", stats.peakImpactForce);
+    printMetric("delta-v (m/s)", stats.totalDeltaV);
+    printMetric("spin error (rad/s)", stats.spinEstimateError);
+    printMetric("time to touchdown (s)", stats.timeToTouchdown);
+    std::cout << "----------------------------------------------------\n";
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "hl_application.h"
+#include "sv_stats.h"
+
+namespace Headless{
+
+//per run entry in a campaign report
+struct CampaignRunResult{
+    int runIndex;
+    std::string outputPath;
+    RunResult result;
+    bool failed = false; //set if the run threw, error holds the message
+    std::string error;
+};
+
+//landing outcome distributions over a campaign, updated as each run finishes so nothing per run has to be kept or re-read
+//touchdown error, impact force and delta-v are over landed runs, time to touchdown is the sim time at touchdown
+struct CampaignStats{
+    uint64_t runs = 0;
+    uint64_t landed = 0;
+    uint64_t failed = 0;
+    double totalSimSeconds = 0;
+    double totalRunWallSeconds = 0;
+    Service::QuantileSketch touchdownError;
+    Service::QuantileSketch peakImpactForce;
+    Service::QuantileSketch totalDeltaV;
+    Service::QuantileSketch spinEstimateError;
+    Service::QuantileSketch timeToTouchdown;
+
+    void add(const CampaignRunResult& runResult);
+    void merge(const CampaignStats& other);
+};
+
+//runs a list of scene variants in parallel, one Headless::Application per run
+//each run gets its own dynamics world, mediator, lander (and so NavigationStruct) and writer output folder
+//workers pull the next unstarted run from a shared counter, so long runs dont hold up the rest of the queue
+class Campaign{
+    public:
+        Campaign(int numWorkers = 0, const std::string& outputRoot = Service::OUT_PATH + "campaign/"); //0 uses hardware_concurrency
+        std::vector<CampaignRunResult> run(const std::vector<SceneData>& variants, double maxSimSeconds);
+        void printSummary(const std::vector<CampaignRunResult>& results); //per run table for small campaigns, then the stats of the last run()
+        double getWallSeconds(){return wallSeconds;};
+        const CampaignStats& getStats(){return stats;};
+        void setRunOutput(bool b){runOutput = b;}; //false runs without a writer, for large sweeps where only the stats are wanted
+    private:
+        const size_t MAX_SUMMARY_ROWS = 100; //bigger campaigns only list failed runs
+
+        int numWorkers;
+        std::string outputRoot;
+        bool runOutput = true;
+        double wallSeconds = 0; //wall time of the whole campaign
+        CampaignStats stats;
+};
+}
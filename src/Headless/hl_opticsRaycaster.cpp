@@ -0,0 +1,81 @@
+#include "hl_opticsRaycaster.h"
+#include "obj_render.h"
+#include "sv_workerPool.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+void Headless::OpticsRaycaster::buildMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Mesh& mesh){
+    if(meshId == mesh.id && !bvh.empty())
+        return;
+    bvh.build(vertices, indices, mesh.indexBase, mesh.indexCount);
+    meshId = mesh.id;
+}
+
+void Headless::OpticsRaycaster::clear(){
+    bvh.clear();
+    meshId = -1;
+}
+
+cv::Mat Headless::OpticsRaycaster::render(const RenderObject& lander, const RenderObject& asteroid, const glm::vec3& sunDirection, float fovDegrees){
+    cv::Mat image = cv::Mat(OUTPUT_IMAGE_WH, OUTPUT_IMAGE_WH, CV_8UC4, cv::Scalar(0, 0, 0, 255));
+    if(bvh.empty())
+        return image;
+
+    //camera to world, same view as populateLanderCameraData
+    glm::mat4 view = glm::lookAt(lander.pos, lander.pos - lander.up, lander.forward);
+    glm::mat3 camToWorld = glm::mat3(glm::inverse(view));
+
+    //asteroid model matrix as built in Vk::Renderer::updateObjectTranslations, rays are moved into model space instead of moving the mesh
+    glm::mat4 model = glm::translate(glm::mat4{1.0f}, asteroid.pos) * asteroid.rot * glm::scale(glm::mat4{1.0f}, asteroid.scale);
+    glm::mat4 worldToModel = glm::inverse(model);
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+    glm::vec3 originModel = glm::vec3(worldToModel * glm::vec4(lander.pos, 1.0f));
+    glm::vec3 toSun = glm::normalize(-sunDirection);
+
+    //perspective uses vertical fov across the full rendered height, the output is the centre crop
+    float tanHalfFov = tan(glm::radians(fovDegrees)*0.5f);
+    float pixelScale = tanHalfFov/(RENDERED_IMAGE_HEIGHT*0.5f);
+    float halfOutput = OUTPUT_IMAGE_WH*0.5f;
+
+    uint32_t tilesPerRow = (OUTPUT_IMAGE_WH + TILE_SIZE - 1)/TILE_SIZE;
+    uint32_t tileCount = tilesPerRow*tilesPerRow;
+    std::atomic<uint32_t> nextTile = 0;
+
+    //each tile writes only its own pixels, so no locking is needed on the image
+    std::function<void()> worker = [&](){
+        for(uint32_t tile = nextTile++; tile < tileCount; tile = nextTile++){
+            uint32_t tileX = (tile % tilesPerRow)*TILE_SIZE;
+            uint32_t tileY = (tile / tilesPerRow)*TILE_SIZE;
+            uint32_t endX = std::min(tileX + TILE_SIZE, OUTPUT_IMAGE_WH);
+            uint32_t endY = std::min(tileY + TILE_SIZE, OUTPUT_IMAGE_WH);
+            for(uint32_t y = tileY; y < endY; y++){
+                cv::Vec4b* row = image.ptr<cv::Vec4b>(y);
+                for(uint32_t x = tileX; x < endX; x++){
+                    //image row 0 is the top, the vulkan projection flips y so view space up is image up
+                    glm::vec3 dirView = glm::vec3((x + 0.5f - halfOutput)*pixelScale, (halfOutput - y - 0.5f)*pixelScale, -1.0f);
+                    glm::vec3 dirWorld = glm::normalize(camToWorld*dirView);
+                    glm::vec3 dirModel = glm::mat3(worldToModel)*dirWorld; //not renormalised so t stays in world units
+
+                    Service::RayHit hit;
+                    if(!bvh.intersect(originModel, dirModel, NEAR_PLANE, FAR_PLANE, hit))
+                        continue;
+
+                    glm::vec3 normal = glm::normalize(normalMatrix*bvh.getNormal(hit));
+                    float diff = std::max(glm::dot(normal, toSun), 0.0f);
+                    float result = OPTICS_AMBIENT + OPTICS_DIFFUSE*diff;
+                    float grey = std::min(pow(result, 1.0f/OPTICS_GAMMA), 1.0f);
+                    uchar value = (uchar)(grey*255.0f);
+                    row[x] = cv::Vec4b(value, value, value, 255);
+                }
+            }
+        }
+    };
+
+    int threadCount = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<uint32_t>(threadCount, tileCount);
+    Service::WorkerPool::shared().parallel(threadCount, worker); //calling thread takes tiles too
+
+    return image;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "sv_meshBvh.h"
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+struct Vertex;
+struct Mesh;
+struct RenderObject;
+
+namespace Headless{
+
+//cpu stand in for Vk::OffscreenRenderer, ray casts the lander optics image against the asteroid mesh
+//camera pose, projection and crop match populateLanderCameraData and convertOffscreenImage, so vision sees the same framing
+//shading is the greyscale directional sun term of greyscale_textured_lit.frag with a constant albedo, textures arent loaded headless
+class OpticsRaycaster{
+    public:
+        void buildMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const Mesh& mesh); //only rebuilds if the mesh id changes
+        void clear();
+        //sunDirection is the direction light travels, same as WorldLightObject::pos for the scene light
+        cv::Mat render(const RenderObject& lander, const RenderObject& asteroid, const glm::vec3& sunDirection, float fovDegrees);
+        void setThreads(int n){numThreads = n;}; //0 uses hardware_concurrency
+    private:
+        Service::MeshBvh bvh;
+        int meshId = -1;
+        int numThreads = 0;
+
+        //must match Vk::OffscreenRenderer, the image is rendered at full window size then the centre is cropped out
+        const uint32_t RENDERED_IMAGE_WIDTH = 1920;
+        const uint32_t RENDERED_IMAGE_HEIGHT = 1080;
+        const uint32_t OUTPUT_IMAGE_WH = 512;
+        const float NEAR_PLANE = 0.1f;
+        const float FAR_PLANE = 15000.0f;
+        const uint32_t TILE_SIZE = 32; //pixels, tiles are handed out to threads from a shared counter
+
+        //LANDER_OPTICS_AMBIENT/DIFFUSE in Vk::OffscreenRenderer, greyscale so one channel is enough
+        const float OPTICS_AMBIENT = 0.005f;
+        const float OPTICS_DIFFUSE = 0.75f;
+        const float OPTICS_GAMMA = 1.1f;
+};
+}
@@ -0,0 +1,117 @@
+#include "hl_renderer.h"
+#include "dmn_iScene.h"
+#include "obj_render.h"
+#include "obj_light.h"
+#include "obj_lander.h"
+#include <algorithm>
+#include "sv_trace.h"
+#include <iostream>
+
+Material* Headless::Renderer::getMaterial(const std::string& name){
+    return &_materials[name]; //no pipelines to look up, just hand back a material to hold the values
+}
+
+//mirrors Vk::Renderer::loadModels without creating the vertex and index buffers
+void Headless::Renderer::loadModels(const std::vector<ModelInfo>& MODEL_INFOS){
+    std::unordered_map<Vertex, uint32_t> uniqueVertices{}; //store unique vertices in here, and check for repeating vertices to push index
+    allIndices.clear();
+    allVertices.clear();
+    _meshes.clear();
+    _loadedMeshes.clear();
+    opticsRaycaster.clear(); //mesh ids are reassigned, any cached bvh is stale
+
+    for(ModelInfo info : MODEL_INFOS){
+        glm::vec3 colour = glm::vec3(0,0,1);
+        if(info.modelName == "sphere")
+            colour = glm::vec3(1,1,1);
+
+        Mesh mesh;
+        mesh.id = _loadedMeshes.size();
+        Vk::loadObjFile(info.filePath, uniqueVertices, colour, allVertices, allIndices, mesh);
+        _loadedMeshes.push_back(mesh);
+        _meshes[info.modelName] = mesh;
+    }
+    std::cout << "Vertices count for all " << allVertices.size() << "\n";
+    std::cout << "Indices count for all " << allIndices.size() << "\n";
+}
+
+Mesh* Headless::Renderer::getLoadedMesh(const std::string& name){
+	auto it = _meshes.find(name);
+	if (it == _meshes.end())
+		return nullptr;
+	return &(*it).second;
+}
+
+void Headless::Renderer::setLightPointers(WorldLightObject* sceneLight, std::vector<WorldPointLightObject>* pointLights, std::vector<WorldSpotLightObject>* spotLights){
+    p_sceneLight = sceneLight;
+}
+
+void Headless::Renderer::resetScene(){
+    std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+    cvMatQueues.clear();
+    p_renderables = nullptr;
+    p_sceneLight = nullptr;
+    pendingOpticsLanders.clear();
+}
+
+//a lander has at most one request waiting, false withdraws it
+void Headless::Renderer::setShouldDrawOffscreen(bool b, int landerSlot){
+    auto it = std::find(pendingOpticsLanders.begin(), pendingOpticsLanders.end(), landerSlot);
+    if(b && it == pendingOpticsLanders.end())
+        pendingOpticsLanders.push_back(landerSlot);
+    else if(!b && it != pendingOpticsLanders.end())
+        pendingOpticsLanders.erase(it);
+}
+
+//same objects as drawOffscreen, asteroid is renderable 3, the star sphere is left out as it is never in view
+//there is no gpu image to wait on, so every lander that asked this frame gets its image now
+void Headless::Renderer::drawFrame(){
+    if(pendingOpticsLanders.empty() || p_renderables == nullptr || p_sceneLight == nullptr)
+        return;
+    TRACE_ZONE("Headless::Renderer::drawFrame");
+
+    RenderObject* asteroid = p_renderables->at(3).get();
+    opticsRaycaster.buildMesh(allVertices, allIndices, _loadedMeshes[asteroid->meshId]);
+    while(!pendingOpticsLanders.empty()){
+        int landerSlot = pendingOpticsLanders.front();
+        pendingOpticsLanders.pop_front();
+        LanderObj* lander = findLander(landerSlot);
+        if(lander == nullptr)
+            continue;
+        cv::Mat image = opticsRaycaster.render(*lander, *asteroid, p_sceneLight->pos, opticsFov);
+
+        std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+        cvMatQueues[landerSlot].push_back(image);
+    }
+}
+
+void Headless::Renderer::popCvMatQueue(int landerSlot){
+    std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+    cvMatQueues[landerSlot].pop_front();
+}
+
+cv::Mat& Headless::Renderer::frontCvMatQueue(int landerSlot){
+    std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+    return cvMatQueues[landerSlot].front();
+}
+
+//renderer has no scene access, the landers are picked out of the renderables
+LanderObj* Headless::Renderer::findLander(int landerSlot){
+    for(std::shared_ptr<RenderObject>& renderable : *p_renderables){
+        LanderObj* lander = dynamic_cast<LanderObj*>(renderable.get());
+        if(lander != nullptr && lander->slot == landerSlot)
+            return lander;
+    }
+    return nullptr;
+}
+
+bool Headless::Renderer::cvMatQueueEmpty(int landerSlot){
+    std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+    auto it = cvMatQueues.find(landerSlot);
+    return it == cvMatQueues.end() || it->second.empty();
+}
+
+void Headless::Renderer::clearCvMatQueue(int landerSlot){
+    std::scoped_lock<std::mutex> lock(cvMatQueueLock);
+    cvMatQueues.erase(landerSlot);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "sv_iRenderEngine.h"
+#include "vk_mesh.h"
+#include "vk_renderer_base.h" //only for Vk::RenderStats, no vulkan objects are created
+#include "hl_opticsRaycaster.h"
+#include <unordered_map>
+#include <mutex>
+
+struct LanderObj;
+
+namespace Headless{
+
+//render engine stand in for batch runs, no window, swapchain, gpu device or ImGui
+//it loads the same models as Vk::Renderer so the asteroid collision mesh and mesh ids match the windowed app
+//everything that only exists to feed the gpu or ui is a no-op, optics images are ray cast on the cpu by OpticsRaycaster
+class Renderer : public IRenderEngine{
+public:
+    void drawFrame(); //call once per sim frame, renders an optics image if one was requested
+    void setOpticsThreads(int n){opticsRaycaster.setThreads(n);};
+
+    Vk::RenderStats& getRenderStats(){return renderStats;};
+    std::vector<Vertex>& get_allVertices(){return allVertices;};
+    std::vector<uint32_t>& get_allIndices(){return allIndices;};
+    Material* getMaterial(const std::string& name);
+    void createTextureImages(const std::vector<TextureInfo>& TEXTURE_INFOS, const std::vector<std::string>& SKYBOX_PATHS){};
+    void loadModels(const std::vector<ModelInfo>& MODEL_INFOS);
+    void setRenderablesPointer(std::vector<std::shared_ptr<RenderObject>>* renderableObjects){p_renderables = renderableObjects;};
+    void allocateDescriptorSetForTexture(std::string materialName, std::string name){};
+    void allocateDescriptorSetForSkybox(){};
+    void setLightPointers(WorldLightObject* sceneLight, std::vector<WorldPointLightObject>* pointLights, std::vector<WorldSpotLightObject>* spotLights);
+    void setCameraData(CameraData* camData){};
+    Mesh* getLoadedMesh(const std::string& name);
+    void mapMaterialDataToGPU(){};
+    void resetScene();
+    void flushTextures(){};
+
+    //optics, images are produced in drawFrame and queued for vision exactly like Vk::OffscreenRenderer
+    void setShouldDrawOffscreen(bool b, int landerSlot);
+    void clearOpticsRequests(){pendingOpticsLanders.clear();};
+    bool isOpticsFramePending(){return !pendingOpticsLanders.empty();};
+    std::vector<ImguiTexturePacket>& getDstTexturePackets(){return imguiTexturePackets;};
+    std::deque<int> getImguiTextureSetIndicesQueue(){return std::deque<int>();};
+    std::deque<int> getImguiDetectionIndicesQueue(){return std::deque<int>();};
+    std::deque<int> getImguiMatchIndicesQueue(){return std::deque<int>();};
+    void popCvMatQueue(int landerSlot);
+    cv::Mat& frontCvMatQueue(int landerSlot);
+    bool cvMatQueueEmpty(int landerSlot);
+    void clearCvMatQueue(int landerSlot);
+    void assignMatToDetectionView(cv::Mat image){};
+    void assignMatToMatchingView(cv::Mat image){};
+    void clearOpticsViews(){};
+    void setOpticsFov(float fov){opticsFov = fov;};
+
+protected:
+    Vk::RenderStats renderStats;
+
+    std::vector<Vertex> allVertices;
+    std::vector<uint32_t> allIndices;
+    std::unordered_map<std::string, Mesh> _meshes;
+    std::vector<Mesh> _loadedMeshes;
+    std::unordered_map<std::string, Material> _materials; //created on request, scene objects write diffuse/specular into them
+
+    std::vector<std::shared_ptr<RenderObject>>* p_renderables = nullptr;
+    WorldLightObject* p_sceneLight = nullptr;
+
+    std::vector<ImguiTexturePacket> imguiTexturePackets; //always empty
+
+    std::mutex cvMatQueueLock;
+    std::unordered_map<int, std::deque<cv::Mat>> cvMatQueues; //finished images by lander slot
+
+    std::deque<int> pendingOpticsLanders; //lander slots that asked for an image since the last drawFrame
+    float opticsFov = 5.0f; //degrees
+
+    OpticsRaycaster opticsRaycaster;
+
+    LanderObj* findLander(int landerSlot);
+};
+}
@@ -1,56 +1,183 @@
 #include "filewriter.h"
 
+Service::Writer::Writer(const std::string& rootPath){
+    outPath = rootPath;
+    navPath = rootPath + "nav/";
+    opticsPath = rootPath + "optics/";
+    opticsFeaturePath = rootPath + "feature/";
+    opticsMatchPath = rootPath + "match/";
+}
+
+std::atomic<uint64_t> Service::Writer::nextWriterId{1};
+
+Service::Writer::~Writer(){
+    closeFiles();
+}
+
 void Service::Writer::writeToFile(std::string file, std::string text){
-    if(file == "NAV")
-        p_file = &navFile;
-    else if(file == "THRUST")
-        p_file = &thrustFile;
-    else if(file == "EST")
-        p_file = &estFile;
-    else if(file == "PARAMS")
-        p_file = &paramsFile;
-    else if(file == "GNC")
-        p_file = &gncFile;
-    else if(file == "PRE")
-        p_file = &preApproachFile;
+    int index;
+    if(file == "PARAMS")
+        index = PARAMS_FILE;
     else
         return;
 
-    if (p_file->is_open())
-        (*p_file) << text << "\n";
-    else 
+    ActiveProducer active(activeProducers);
+    if(!running.load()){
         std::cout << "Unable to open file " + file + "\n";
+        return;
+    }
+
+    ProducerRing* ring = getProducerRing();
+    uint64_t tail;
+    Line* line = beginPush(ring, tail);
+    if(line == nullptr)
+        return;
+    line->file = index;
+    line->text = std::move(text);
+    ring->tail.store(tail + 1, std::memory_order_release);
+}
+
+void Service::Writer::writeRecord(const TelemetryRecord& record){
+    ActiveProducer active(activeProducers);
+    if(!running.load())
+        return;
+
+    ProducerRing* ring = getProducerRing();
+    uint64_t tail;
+    Line* line = beginPush(ring, tail);
+    if(line == nullptr)
+        return;
+    line->file = TELEMETRY_FILE;
+    line->record = record;
+    ring->tail.store(tail + 1, std::memory_order_release);
+}
+
+void Service::Writer::writeImage(const std::string& path, cv::Mat image){
+    imageEncoder.enqueue(path, std::move(image));
+}
+
+Service::Writer::Line* Service::Writer::beginPush(ProducerRing* ring, uint64_t& tail){
+    tail = ring->tail.load(std::memory_order_relaxed);
+    while(tail - ring->head.load(std::memory_order_acquire) >= RING_CAPACITY){ //full, only happens if the disk cant keep up
+        if(!running.load(std::memory_order_acquire))
+            return nullptr;
+        std::this_thread::yield();
+    }
+    return &ring->lines[tail % RING_CAPACITY];
+}
+
+Service::Writer::ProducerRing* Service::Writer::getProducerRing(){
+    static thread_local RingLease lease;
+    if(lease.writerId == writerId)
+        return lease.ring.get();
+    lease.release(); //this thread last wrote to a different writer
+
+    std::scoped_lock<std::mutex> lock(ringsLock);
+    for(std::shared_ptr<ProducerRing>& ring : rings){
+        //a released ring can be taken over once the writer thread has emptied it, so one threads lines never mix with anothers
+        if(!ring->owned.load(std::memory_order_acquire) && ring->head.load(std::memory_order_acquire) == ring->tail.load(std::memory_order_relaxed)){
+            ring->owned.store(true, std::memory_order_relaxed);
+            lease.ring = ring;
+            lease.writerId = writerId;
+            return lease.ring.get();
+        }
+    }
+    rings.push_back(std::make_shared<ProducerRing>());
+    lease.ring = rings.back();
+    lease.writerId = writerId;
+    return lease.ring.get();
+}
+
+bool Service::Writer::drainRings(){
+    std::vector<std::shared_ptr<ProducerRing>> snapshot;
+    {
+        std::scoped_lock<std::mutex> lock(ringsLock);
+        snapshot = rings;
+    }
+
+    bool wrote = false;
+    for(std::shared_ptr<ProducerRing>& ring : snapshot){
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        uint64_t tail = ring->tail.load(std::memory_order_acquire);
+        for(; head < tail; head++){
+            Line& line = ring->lines[head % RING_CAPACITY];
+            if(line.file == TELEMETRY_FILE)
+                runLog.append(line.record);
+            else{
+                if(files[line.file].is_open())
+                    files[line.file] << line.text << "\n";
+                line.text.clear();
+            }
+            wrote = true;
+        }
+        ring->head.store(head, std::memory_order_release);
+    }
+    return wrote;
+}
+
+void Service::Writer::writerLoop(){
+    auto lastFlush = std::chrono::steady_clock::now();
+    while(running.load(std::memory_order_acquire)){
+        bool wrote = drainRings();
+
+        auto now = std::chrono::steady_clock::now();
+        if(now - lastFlush >= FLUSH_INTERVAL){
+            for(std::ofstream& file : files)
+                file.flush();
+            runLog.sync();
+            lastFlush = now;
+        }
+
+        if(!wrote){
+            std::unique_lock<std::mutex> lock(wakeLock);
+            wake.wait_for(lock, DRAIN_INTERVAL, [this](){return !running.load(std::memory_order_acquire);});
+        }
+    }
+    //a producer that passed the running check just before closeFiles may still be pushing, its line has to make the final drain
+    //both sides use seq_cst, so either it saw running false or we see it counted here
+    while(activeProducers.load() != 0)
+        std::this_thread::yield();
+    drainRings(); //anything queued before closeFiles
 }
 
 void Service::Writer::openFiles(){
-    navFile.open(NAV_PATH + "nav.txt", std::ios_base::app);
-    thrustFile.open(NAV_PATH + "thrust.txt", std::ios_base::app);
-    estFile.open(NAV_PATH + "estimates.txt", std::ios_base::app);
-    paramsFile.open(NAV_PATH + "params.txt", std::ios_base::app);
-    preApproachFile.open(NAV_PATH + "preapproach.txt", std::ios_base::app);
-    gncFile.open(NAV_PATH + "gnc.txt", std::ios_base::app);
+    if(running)
+        return;
+    files[PARAMS_FILE].open(navPath + "params.txt", std::ios_base::app);
+    runLog.open(navPath + "runlog.lsr");
+    if(OUTPUT_OPTICS)
+        imageEncoder.start(OUTPUT_OPTICS_FORMAT, IMAGE_ENCODER_THREADS, IMAGE_ENCODER_CAPACITY);
+    running = true;
+    writerThread = std::thread(&Service::Writer::writerLoop, this);
     std::cout << "Files opened\n";
 }
 
+//producers still writing after this (eg a vision thread finishing late) get the unable to open message instead of blocking
 void Service::Writer::closeFiles(){
-    navFile.close();
-    thrustFile.close();
-    estFile.close();
-    paramsFile.close();
-    preApproachFile.close();
-    gncFile.close();
+    if(!running)
+        return;
+    {
+        std::scoped_lock<std::mutex> lock(wakeLock);
+        running = false;
+    }
+    wake.notify_all();
+    writerThread.join();
+    for(std::ofstream& file : files)
+        file.close();
+    runLog.close();
+    imageEncoder.stop();
     std::cout << "Files closed\n";
 }
 
 void Service::Writer::clearOutputFolders(){
     //set up directories
     try{
-        std::filesystem::remove_all(OUT_PATH);
-        std::filesystem::create_directory(OUT_PATH);
-        std::filesystem::create_directory(NAV_PATH);
-        std::filesystem::create_directory(OPTICS_PATH);
-        std::filesystem::create_directory(OPTICS_FEATURE_PATH);
-        std::filesystem::create_directory(OPTICS_MATCH_PATH);
+        std::filesystem::remove_all(outPath);
+        std::filesystem::create_directories(outPath); //root may be nested for campaign runs
+        std::filesystem::create_directory(navPath);
+        std::filesystem::create_directory(opticsPath);
+        std::filesystem::create_directory(opticsFeaturePath);
+        std::filesystem::create_directory(opticsMatchPath);
     }
     catch (const std::exception &e){
         std::cerr << e.what() << std::endl;
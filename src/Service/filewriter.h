@@ -3,33 +3,128 @@
 #include <iostream>
 #include <fstream>
 #include <filesystem>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <array>
+#include <chrono>
+#include "sv_telemetry.h"
+#include "sv_runlog.h"
+#include "sv_imageEncoder.h"
 
 namespace Service{
     const bool OUTPUT_TEXT = true;
     const bool OUTPUT_OPTICS = true;
+    const bool OUTPUT_REPLAY = true; //replay.lsrp in the output folder, needs OUTPUT_TEXT
+    const ImageFormat OUTPUT_OPTICS_FORMAT = ImageFormat::Jpeg; //Raw or PngFast are cheaper to encode but much bigger on disk
     const std::string OUT_PATH = "output/";
     const std::string NAV_PATH = OUT_PATH + "nav/";
     const std::string OPTICS_PATH = OUT_PATH + "optics/";
     const std::string OPTICS_FEATURE_PATH = OUT_PATH + "feature/";
     const std::string OPTICS_MATCH_PATH = OUT_PATH + "match/";
 
+    //text output for experiment data
+    //writeToFile only moves the line into a ring buffer owned by the calling thread, a background thread started by openFiles
+    //drains every ring into the files and flushes them in batches, so the physics thread never waits on disk and the
+    //detached vision threads can write at the same time without a lock
+    //lines from one thread keep their order, lines from different threads are interleaved in drain order
+    //gnc and estimation data goes through writeRecord as fixed size telemetry records into the columnar runlog.lsr,
+    //LSRunLog slices it by time, exports csv or converts it back to the old text files offline
     class Writer{
         private:
 
-        std::ofstream* p_file;
+        //root and sub folders for this writer, defaults to the constants above
+        //batch campaigns give each worker its own root so runs dont overwrite each other
+        std::string outPath = OUT_PATH;
+        std::string navPath = NAV_PATH;
+        std::string opticsPath = OPTICS_PATH;
+        std::string opticsFeaturePath = OPTICS_FEATURE_PATH;
+        std::string opticsMatchPath = OPTICS_MATCH_PATH;
+
+        enum FileIndex{PARAMS_FILE, NUM_FILES, TELEMETRY_FILE = NUM_FILES};
+        std::array<std::ofstream, NUM_FILES> files;
+        RunLogWriter runLog;
+
+        static const uint32_t RING_CAPACITY = 1024; //lines per producer, a producer yields if the writer thread falls this far behind
+        const std::chrono::milliseconds DRAIN_INTERVAL = std::chrono::milliseconds(2); //writer thread sleep when there was nothing to write
+        const std::chrono::milliseconds FLUSH_INTERVAL = std::chrono::milliseconds(250); //files are flushed at most this often while running
+
+        //a text line, or a telemetry record if file is TELEMETRY_FILE
+        struct Line{
+            int file;
+            std::string text;
+            TelemetryRecord record;
+        };
+
+        //single producer single consumer, the owning thread advances tail and the writer thread advances head
+        struct ProducerRing{
+            std::unique_ptr<Line[]> lines = std::make_unique<Line[]>(RING_CAPACITY);
+            std::atomic<uint64_t> head{0};
+            std::atomic<uint64_t> tail{0};
+            std::atomic<bool> owned{true}; //cleared when the producer thread exits or moves to another writer, the ring is then reused
+        };
+
+        //per thread cache of the ring it last wrote to, writer ids are never reused so a destroyed writer cant be mistaken for a new one
+        struct RingLease{
+            uint64_t writerId = 0;
+            std::shared_ptr<ProducerRing> ring;
+            ~RingLease(){release();};
+            void release(){
+                if(ring)
+                    ring->owned.store(false, std::memory_order_release);
+                ring.reset();
+                writerId = 0;
+            };
+        };
+
+        static std::atomic<uint64_t> nextWriterId;
+        uint64_t writerId = nextWriterId++;
+
+        std::mutex ringsLock; //only taken when a thread writes to this writer for the first time
+        std::vector<std::shared_ptr<ProducerRing>> rings;
+
+        const int IMAGE_ENCODER_THREADS = 2;
+        const size_t IMAGE_ENCODER_CAPACITY = 16; //queued debug images, more than this and new ones are dropped
+        ImageEncoder imageEncoder;
+
+        std::atomic<bool> running{false};
+        std::atomic<int> activeProducers{0}; //writes that have passed the running check, the final drain waits for them
+
+        //counts a write in flight for its scope, taken before running is checked so closeFiles cant slip in between
+        struct ActiveProducer{
+            std::atomic<int>& count;
+            ActiveProducer(std::atomic<int>& activeCount): count{activeCount}{count++;};
+            ~ActiveProducer(){count--;};
+        };
+
+        std::thread writerThread;
+        std::mutex wakeLock;
+        std::condition_variable wake; //only used to stop the writer thread promptly, producers never notify
+
+        ProducerRing* getProducerRing();
+        Line* beginPush(ProducerRing* ring, uint64_t& tail); //nullptr if the writer stopped while the ring was full
+        void writerLoop();
+        bool drainRings(); //true if anything was written
 
         public:
 
-        std::ofstream navFile;
-        std::ofstream thrustFile;
-        std::ofstream estFile;
-        std::ofstream paramsFile;
-        std::ofstream preApproachFile;
-        std::ofstream gncFile;
+        Writer(){};
+        Writer(const std::string& rootPath); //rootPath should end with a /
+        ~Writer();
+
+        const std::string& getOutPath(){return outPath;};
+        const std::string& getOpticsPath(){return opticsPath;};
+        const std::string& getOpticsFeaturePath(){return opticsFeaturePath;};
+        const std::string& getOpticsMatchPath(){return opticsMatchPath;};
 
-        void writeToFile(std::string file, std::string text);
-        void openFiles();
-        void closeFiles();
+        void writeToFile(std::string file, std::string text); //"PARAMS", for occasional lines
+        void writeRecord(const TelemetryRecord& record); //no allocation, safe to call every tick
+        void writeImage(const std::string& path, cv::Mat image); //path without extension, encoded on the image pool, dropped if it is full
+        void openFiles(); //also starts the writer thread
+        void closeFiles(); //writes everything still queued, then stops the writer thread
         void clearOutputFolders();
     };
-}
\ No newline at end of file
+}
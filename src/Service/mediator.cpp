@@ -15,13 +15,23 @@ WorldObject& Mediator::scene_getWorldObject(int i){
 WorldObject& Mediator::scene_getFocusableObject(std::string name){
     return p_scene->getFocusableObject(name);
 }
+WorldObject* Mediator::scene_getEntity(EntityHandle handle){
+    return p_scene->getEntity(handle);
+}
+EntityHandle Mediator::scene_findEntity(const std::string& name){
+    return p_scene->getEntityRegistry().find(name);
+}
 LandingSiteObj* Mediator::scene_getLandingSiteObject(){
     MyScene* ls = dynamic_cast<MyScene*>(p_scene);
     return ls->getLandingSiteObject();
 }
-LanderObj* Mediator::scene_getLanderObject(){
+LanderObj* Mediator::scene_getLanderObject(int slot){
     MyScene* ls = dynamic_cast<MyScene*>(p_scene);
-    return ls->getLanderObject();
+    return ls->getLanderObject(slot);
+}
+Lander::Fleet* Mediator::scene_getLanderFleet(){
+    MyScene* ls = dynamic_cast<MyScene*>(p_scene);
+    return ls->getLanderFleet();
 }
 std::vector<std::shared_ptr<RenderObject>>* Mediator::scene_getDebugObjects(){
     return p_scene->getDebugObjects();
@@ -38,10 +48,12 @@ void Mediator::ui_drawUI(){
     p_uiHandler->drawUI();
 }
 void Mediator::ui_updateLoadingProgress(float progress, std::string text){
-    p_uiHandler->updateLoadingProgress(progress, text);
+    if(p_uiHandler) //no ui when headless
+        p_uiHandler->updateLoadingProgress(progress, text);
 }
 void Mediator::ui_submitBoostCommand(LanderBoostCommand boost){
-    p_uiHandler->submitBoostCommand(boost);
+    if(p_uiHandler) //no ui when headless
+        p_uiHandler->submitBoostCommand(boost);
 }
 
 //Camera functions
@@ -58,6 +70,8 @@ void Mediator::camera_setMouseLookActive(bool state){
     p_worldCamera->setMouseLookActive(state);
 }
 CameraData* Mediator::camera_getCameraDataPointer(){
+    if(!p_worldCamera) //no camera when headless
+        return nullptr;
     return p_worldCamera->getCameraDataPtr();
 }
 void Mediator::camera_toggleAutoCamera(){
@@ -71,8 +85,8 @@ void Mediator::physics_changeSimSpeed(int direction, bool pause){
 WorldStats& Mediator::physics_getWorldStats(){
     return p_physicsEngine->getWorldStats();
 }
-void Mediator::physics_loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects){
-    p_physicsEngine->loadCollisionMeshes(collisionObjects);
+void Mediator::physics_loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects, Lander::Fleet* landerFleet){
+    p_physicsEngine->loadCollisionMeshes(collisionObjects, landerFleet);
 }
 void Mediator::physics_reset(){
     p_physicsEngine->reset();
@@ -88,12 +102,33 @@ void Mediator::physics_moveLandingSite(float x, float y, float z, bool torque){
 void Mediator::physics_updateDeltaTime(){
     p_physicsEngine->updateDeltaTime();
 }
-void Mediator::physics_landerCollided(){
-    scene_getLanderObject()->landerCollided();
+void Mediator::physics_toggleClockMode(){
+    p_physicsEngine->toggleClockMode();
+}
+void Mediator::physics_toggleMaxThroughput(){
+    p_physicsEngine->toggleMaxThroughput();
+}
+void Mediator::physics_quickSave(){
+    p_physicsEngine->quickSave();
+}
+void Mediator::physics_quickLoad(){
+    p_physicsEngine->quickLoad();
+}
+void Mediator::physics_recordBoost(const glm::vec3& vector){
+    p_physicsEngine->recordBoost(vector);
+}
+void Mediator::physics_landerCollided(int landerSlot){
+    scene_getLanderObject(landerSlot)->landerCollided();
 }
 glm::vec3 Mediator::physics_performRayCast(glm::vec3 from, glm::vec3 dir, float range){
     return p_physicsEngine->performRayCast(from, dir, range);
 }
+void Mediator::physics_performRayCasts(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range){
+    p_physicsEngine->performRayCasts(origins, dirs, hits, range);
+}
+AsteroidRayFrame Mediator::physics_getAsteroidRayFrame(){
+    return p_physicsEngine->getAsteroidRayFrame();
+}
 double Mediator::physics_getTimeStamp(){
     return p_physicsEngine->getTimeStamp();
 }
@@ -147,8 +182,8 @@ void Mediator::renderer_resetScene(){
 void Mediator::renderer_flushTextures(){
     p_renderEngine->flushTextures();
 }
-void Mediator::renderer_setShouldDrawOffscreen(bool b){
-    p_renderEngine->setShouldDrawOffscreen(b);
+void Mediator::renderer_setShouldDrawOffscreen(bool b, int landerSlot){
+    p_renderEngine->setShouldDrawOffscreen(b, landerSlot);
 }
 std::vector<ImguiTexturePacket>& Mediator::renderer_getDstTexturePackets(){
     return p_renderEngine->getDstTexturePackets();
@@ -162,14 +197,20 @@ std::deque<int> Mediator::renderer_getImguiDetectionIndicesQueue(){
 std::deque<int> Mediator::renderer_getImguiMatchIndicesQueue(){
     return p_renderEngine->getImguiMatchIndicesQueue();
 }
-void Mediator::renderer_popCvMatQueue(){
-    return p_renderEngine->popCvMatQueue();
+void Mediator::renderer_popCvMatQueue(int landerSlot){
+    return p_renderEngine->popCvMatQueue(landerSlot);
+}
+cv::Mat& Mediator::renderer_frontCvMatQueue(int landerSlot){
+    return p_renderEngine->frontCvMatQueue(landerSlot);
+}
+bool Mediator::renderer_isOpticsFramePending(){
+    return p_renderEngine->isOpticsFramePending();
 }
-cv::Mat& Mediator::renderer_frontCvMatQueue(){
-    return p_renderEngine->frontCvMatQueue();
+bool Mediator::renderer_cvMatQueueEmpty(int landerSlot){
+    return p_renderEngine->cvMatQueueEmpty(landerSlot);
 }
-bool Mediator::renderer_cvMatQueueEmpty(){
-    return p_renderEngine->cvMatQueueEmpty();
+void Mediator::renderer_clearCvMatQueue(int landerSlot){
+    return p_renderEngine->clearCvMatQueue(landerSlot);
 }
 void Mediator::renderer_assignMatToDetectionView(cv::Mat image){
     return p_renderEngine->assignMatToDetectionView(image);
@@ -194,13 +235,44 @@ void Mediator::application_endScene(){
 void Mediator::application_resetScene(){
     p_application->resetScene();
 }
+void Mediator::application_toggleTraceCapture(){
+    p_application->toggleTraceCapture();
+}
 bool Mediator::application_getSceneLoaded(){
     return p_application->getSceneLoaded();
 }
 
-//writer functions
+//writer functions, no writer set means output is off for this run (eg headless campaigns that only want the stats)
 void Mediator::writer_writeToFile(std::string file, std::string text){
-    return p_writer->writeToFile(file, text);
+    if(p_writer)
+        p_writer->writeToFile(file, text);
+}
+void Mediator::writer_writeRecord(Service::TelemetryChannel channel, double timestamp, const glm::vec3& value){
+    if(p_writer)
+        p_writer->writeRecord(Service::TelemetryRecord{timestamp, channel, {value.x, value.y, value.z}});
+}
+void Mediator::writer_writeRecord(const Service::TelemetryRecord& record){
+    if(p_writer)
+        p_writer->writeRecord(record);
+}
+void Mediator::writer_writeImage(const std::string& path, cv::Mat image){
+    if(p_writer)
+        p_writer->writeImage(path, std::move(image));
+}
+std::string Mediator::writer_getOpticsPath(){
+    if(!p_writer) //writer is only set when OUTPUT_TEXT is on
+        return Service::OPTICS_PATH;
+    return p_writer->getOpticsPath();
+}
+std::string Mediator::writer_getOpticsFeaturePath(){
+    if(!p_writer)
+        return Service::OPTICS_FEATURE_PATH;
+    return p_writer->getOpticsFeaturePath();
+}
+std::string Mediator::writer_getOpticsMatchPath(){
+    if(!p_writer)
+        return Service::OPTICS_MATCH_PATH;
+    return p_writer->getOpticsMatchPath();
 }
 
 //set pointers
@@ -213,7 +285,7 @@ void Mediator::setPhysicsEngine(WorldPhysics* physicsEngine){
 void Mediator::setCamera(WorldCamera* camera){
     p_worldCamera = camera;
 }
-void Mediator::setRenderEngine(Vk::OffscreenRenderer* renderer){
+void Mediator::setRenderEngine(IRenderEngine* renderer){
     p_renderEngine = renderer;
 }
 void Mediator::setScene(IScene* scene){
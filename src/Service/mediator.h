@@ -9,6 +9,7 @@
 #include <deque>
 #include "opencv2/opencv.hpp"
 #include "filewriter.h"
+#include "sv_iRenderEngine.h"
 
 class WorldCamera;
 class UiHandler;
@@ -20,12 +21,13 @@ class CollisionRenderObj;
 class GLFWwindow;
 
 namespace Vk{
-    class OffscreenRenderer;
     struct RenderStats;
 }
 
 struct CameraData;
 struct Mesh;
+struct RayCastHit; //defined in world_physics.h
+struct AsteroidRayFrame;
 struct Vertex;
 struct Material;
 struct TextureInfo;
@@ -39,47 +41,66 @@ struct WorldStats;
 struct LandingSiteObj;
 struct LanderObj;
 struct LanderBoostCommand;
+struct EntityHandle;
 
 struct ImguiTexturePacket;
 
 class IScene;
 
+namespace Lander{
+    class Fleet;
+}
+
 class Mediator{
     private:
-        WorldCamera* p_worldCamera;
-        UiHandler* p_uiHandler;
-        WorldPhysics* p_physicsEngine;
-        Vk::OffscreenRenderer* p_renderEngine;
-        IScene* p_scene;
-        Application* p_application;
-        Service::Writer* p_writer;
+        //camera, ui and application are left null when running headless, see Headless::Application
+        WorldCamera* p_worldCamera = nullptr;
+        UiHandler* p_uiHandler = nullptr;
+        WorldPhysics* p_physicsEngine = nullptr;
+        IRenderEngine* p_renderEngine = nullptr;
+        IScene* p_scene = nullptr;
+        Application* p_application = nullptr;
+        Service::Writer* p_writer = nullptr;
         
     public:
         //set pointers
         void setCamera(WorldCamera* camera);
         void setUiHandler(UiHandler* uiHandler);
         void setPhysicsEngine(WorldPhysics* physicsEngine);
-        void setRenderEngine(Vk::OffscreenRenderer* renderer);
+        void setRenderEngine(IRenderEngine* renderer);
         void setScene(IScene* scene);
         void setApplication(Application* application);
         void setWriter(Service::Writer* writer);
 
         //writer functions
         void writer_writeToFile(std::string file, std::string text);
+        void writer_writeRecord(Service::TelemetryChannel channel, double timestamp, const glm::vec3& value);
+        void writer_writeRecord(const Service::TelemetryRecord& record);
+        void writer_writeImage(const std::string& path, cv::Mat image);
+        std::string writer_getOpticsPath();
+        std::string writer_getOpticsFeaturePath();
+        std::string writer_getOpticsMatchPath();
 
         //physics functions
         void physics_changeSimSpeed(int direction, bool pause);
         WorldStats& physics_getWorldStats();
-        void physics_loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects);
+        void physics_loadCollisionMeshes(std::vector<std::shared_ptr<CollisionRenderObj>>* collisionObjects, Lander::Fleet* landerFleet);
         void physics_reset();
         //bool physics_landerImpulseRequested();
         //LanderBoostCommand& physics_popLanderImpulseQueue();
         void physics_addImpulseToLanderQueue(float duration, float x, float y, float z, bool torque = false);
         void physics_moveLandingSite(float x, float y, float z, bool torque = false);
         void physics_updateDeltaTime();
-        void physics_landerCollided();
+        void physics_toggleClockMode();
+        void physics_toggleMaxThroughput();
+        void physics_quickSave();
+        void physics_quickLoad();
+        void physics_recordBoost(const glm::vec3& vector);
+        void physics_landerCollided(int landerSlot = 0);
         //void physics_initDynamicsWorld();
         glm::vec3 physics_performRayCast(glm::vec3 from, glm::vec3 dir, float range);
+        void physics_performRayCasts(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& dirs, std::vector<RayCastHit>& hits, float range);
+        AsteroidRayFrame physics_getAsteroidRayFrame();
         double physics_getTimeStamp();
 
         //camera functions
@@ -107,14 +128,16 @@ class Mediator{
         void renderer_mapMaterialDataToGPU();
         void renderer_resetScene();
         void renderer_flushTextures();
-        void renderer_setShouldDrawOffscreen(bool b);
+        void renderer_setShouldDrawOffscreen(bool b, int landerSlot = 0);
+        bool renderer_isOpticsFramePending();
         std::vector<ImguiTexturePacket>& renderer_getDstTexturePackets();
         std::deque<int> renderer_getImguiTextureSetIndicesQueue();
         std::deque<int> renderer_getImguiDetectionIndicesQueue();
         std::deque<int> renderer_getImguiMatchIndicesQueue();
-        void renderer_popCvMatQueue();
-        cv::Mat& renderer_frontCvMatQueue();
-        bool renderer_cvMatQueueEmpty();
+        void renderer_popCvMatQueue(int landerSlot);
+        cv::Mat& renderer_frontCvMatQueue(int landerSlot);
+        bool renderer_cvMatQueueEmpty(int landerSlot);
+        void renderer_clearCvMatQueue(int landerSlot);
         void renderer_assignMatToDetectionView(cv::Mat image);
         void renderer_assignMatToMatchingView(cv::Mat image);
         void renderer_clearOpticsViews();
@@ -124,8 +147,11 @@ class Mediator{
         int scene_getWorldObjectsCount();
         WorldObject& scene_getWorldObject(int i);
         WorldObject& scene_getFocusableObject(std::string name);
+        WorldObject* scene_getEntity(EntityHandle handle);
+        EntityHandle scene_findEntity(const std::string& name);
         LandingSiteObj* scene_getLandingSiteObject();
-        LanderObj* scene_getLanderObject();
+        LanderObj* scene_getLanderObject(int slot = 0); //0 is the primary lander, nullptr if the scene has no lander in that slot
+        Lander::Fleet* scene_getLanderFleet();
         std::vector<std::shared_ptr<RenderObject>>* scene_getDebugObjects();
 
         //ui functions
@@ -140,4 +166,5 @@ class Mediator{
         void application_endScene();
         void application_resetScene();
         bool application_getSceneLoaded();
+        void application_toggleTraceCapture();
 };
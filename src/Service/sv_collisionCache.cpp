@@ -0,0 +1,132 @@
+#include "sv_collisionCache.h"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static uint64_t align16(uint64_t offset){
+    return (offset + 15) & ~static_cast<uint64_t>(15);
+}
+
+uint64_t Service::cookedMeshKey(const float* positions, size_t numFloats, const btVector3& scale){
+    uint64_t hash = 14695981039346656037ull;
+    auto addBytes = [&hash](const void* data, size_t bytes){
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < bytes; i++){
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    addBytes(positions, numFloats*sizeof(float));
+    float s[3] = {static_cast<float>(scale.x()), static_cast<float>(scale.y()), static_cast<float>(scale.z())};
+    addBytes(s, sizeof(s));
+    return hash;
+}
+
+std::string Service::cookedMeshPath(uint64_t key){
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.lscol", static_cast<unsigned long long>(key));
+    return COLLISION_CACHE_PATH + name;
+}
+
+Service::CookedTriangleMesh::~CookedTriangleMesh(){
+    unmap();
+}
+
+void Service::CookedTriangleMesh::unmap(){
+    meshInterface.reset();
+    bvh = nullptr;
+    if(mapped != nullptr)
+        munmap(mapped, mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+bool Service::CookedTriangleMesh::load(const std::string& path, uint64_t key){
+    unmap();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CookedMeshHeader))){
+        ::close(fd);
+        return false;
+    }
+    mappedSize = info.st_size;
+    mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED){
+        mapped = nullptr;
+        mappedSize = 0;
+        return false;
+    }
+
+    char* base = static_cast<char*>(mapped);
+    CookedMeshHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    bool valid = std::memcmp(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic)) == 0 && header.version == COOKED_MESH_VERSION
+        && header.scalarBytes == sizeof(btScalar) && header.key == key
+        && header.verticesOffset + 3ull*header.numVertices*sizeof(btScalar) <= mappedSize
+        && header.indicesOffset + 3ull*header.numTriangles*sizeof(int32_t) <= mappedSize
+        && header.bvhOffset % 16 == 0 && header.bvhOffset + header.bvhBytes <= mappedSize;
+    if(valid)
+        bvh = btOptimizedBvh::deSerializeInPlace(base + header.bvhOffset, header.bvhBytes, false); //null if the size doesnt match
+    if(!valid || bvh == nullptr){
+        unmap();
+        return false;
+    }
+
+    meshInterface = std::make_unique<btTriangleIndexVertexArray>(header.numTriangles, reinterpret_cast<int*>(base + header.indicesOffset), 3*sizeof(int32_t),
+        header.numVertices, reinterpret_cast<btScalar*>(base + header.verticesOffset), 3*sizeof(btScalar));
+    return true;
+}
+
+bool Service::CookedTriangleMesh::write(const std::string& path, uint64_t key, btTriangleMesh& mesh, const btOptimizedBvh& bvh){
+    const btIndexedMesh& part = mesh.getIndexedMeshArray()[0];
+    if(part.m_indexType != PHY_INTEGER || part.m_vertexType != (sizeof(btScalar) == sizeof(float) ? PHY_FLOAT : PHY_DOUBLE)
+        || part.m_vertexStride != 3*sizeof(btScalar) || part.m_triangleIndexStride != 3*sizeof(int32_t))
+        return false; //only the layout btTriangleMesh(true, false) produces
+
+    CookedMeshHeader header;
+    std::memcpy(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic));
+    header.version = COOKED_MESH_VERSION;
+    header.scalarBytes = sizeof(btScalar);
+    header.key = key;
+    header.numVertices = part.m_numVertices;
+    header.numTriangles = part.m_numTriangles;
+    header.verticesOffset = align16(sizeof(header));
+    header.indicesOffset = align16(header.verticesOffset + 3ull*part.m_numVertices*sizeof(btScalar));
+    header.bvhOffset = align16(header.indicesOffset + 3ull*part.m_numTriangles*sizeof(int32_t));
+    header.bvhBytes = bvh.calculateSerializeBufferSize();
+
+    //serializeInPlace needs an aligned buffer, the bvh ends up at an aligned offset of a page aligned mapping
+    std::vector<char> file(header.bvhOffset + header.bvhBytes + 16, 0);
+    char* aligned = reinterpret_cast<char*>(align16(reinterpret_cast<uintptr_t>(file.data())));
+    std::memcpy(aligned, &header, sizeof(header));
+    std::memcpy(aligned + header.verticesOffset, part.m_vertexBase, 3ull*part.m_numVertices*sizeof(btScalar));
+    std::memcpy(aligned + header.indicesOffset, part.m_triangleIndexBase, 3ull*part.m_numTriangles*sizeof(int32_t));
+    if(!bvh.serializeInPlace(aligned + header.bvhOffset, header.bvhBytes, false))
+        return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(aligned, header.bvhOffset + header.bvhBytes);
+        if(!out){
+            std::cout << "Unable to write collision cache " + path + "\n";
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error); //atomic, a concurrent writer of the same key produces the same bytes
+    return !error;
+}
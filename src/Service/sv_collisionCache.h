@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <memory>
+#include <bullet/btBulletDynamicsCommon.h>
+
+namespace Service{
+
+    //cooked collision meshes, the triangles and quantized bvh of a btBvhTriangleMeshShape written once and mapped on later loads
+    //layout, native endian and btScalar as written by the host, so a cache is only valid for the build that wrote it:
+    //  header: CookedMeshHeader
+    //  vertices: btScalar[3*numVertices], unscaled model space
+    //  indices: int32[3*numTriangles]
+    //  bvh: btOptimizedBvh::serializeInPlace output, 16 byte aligned
+    //the key hashes the mesh triangles and the scale, the bvh is built on scaled vertices so a new scale is a new file
+    const std::string COLLISION_CACHE_PATH = "cache/collision/";
+    const char COOKED_MESH_MAGIC[8] = {'L','S','C','O','O','K','E','D'};
+    const uint32_t COOKED_MESH_VERSION = 1;
+
+    struct CookedMeshHeader{
+        char magic[8];
+        uint32_t version;
+        uint32_t scalarBytes;
+        uint64_t key;
+        uint32_t numVertices;
+        uint32_t numTriangles;
+        uint64_t verticesOffset;
+        uint64_t indicesOffset;
+        uint64_t bvhOffset;
+        uint64_t bvhBytes;
+    };
+
+    static_assert(sizeof(CookedMeshHeader) == 64, "cooked mesh header is written to disk as is");
+
+    //fnv-1a over the triangle corners in index order and the scale
+    uint64_t cookedMeshKey(const float* positions, size_t numFloats, const btVector3& scale);
+    std::string cookedMeshPath(uint64_t key);
+
+    //a mapped cache file, the mesh interface and bvh point into the mapping so it must outlive any shape built from them
+    //the mapping is private and writable because bullet fixes up the bvh pointers in place
+    class CookedTriangleMesh{
+        public:
+            ~CookedTriangleMesh();
+            bool load(const std::string& path, uint64_t key); //false if missing, from another build or for another key
+            btStridingMeshInterface* getMeshInterface(){return meshInterface.get();};
+            btOptimizedBvh* getBvh(){return bvh;};
+
+            //writes a mesh built with btTriangleMesh(true, false) and its shape's bvh, through a temp file so parallel runs never see half a cache
+            static bool write(const std::string& path, uint64_t key, btTriangleMesh& mesh, const btOptimizedBvh& bvh);
+
+        private:
+            void* mapped = nullptr;
+            size_t mappedSize = 0;
+            std::unique_ptr<btTriangleIndexVertexArray> meshInterface;
+            btOptimizedBvh* bvh = nullptr; //lives in the mapping, never deleted
+
+            void unmap();
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include "opencv2/opencv.hpp"
+
+//forward declare, render engines define these in vk_types.h and vk_mesh.h
+struct Vertex;
+struct Mesh;
+struct Material;
+struct ImguiTexturePacket;
+struct TextureInfo;
+struct ModelInfo;
+struct CameraData;
+struct WorldLightObject;
+struct WorldPointLightObject;
+struct WorldSpotLightObject;
+struct RenderObject;
+
+namespace Vk{
+    struct RenderStats;
+}
+
+//the subset of a render engine the mediator exposes to the rest of the program
+//implemented by Vk::RendererBase and its children for the windowed app, and by Headless::Renderer for batch runs
+//signatures need to match the Vk renderer methods exactly so they override without extra forwarding code
+class IRenderEngine{
+    public:
+        virtual Vk::RenderStats& getRenderStats() = 0;
+        virtual std::vector<Vertex>& get_allVertices() = 0;
+        virtual std::vector<uint32_t>& get_allIndices() = 0;
+        virtual Material* getMaterial(const std::string& name) = 0;
+        virtual void createTextureImages(const std::vector<TextureInfo>& TEXTURE_INFOS, const std::vector<std::string>& SKYBOX_PATHS) = 0;
+        virtual void loadModels(const std::vector<ModelInfo>& MODEL_INFOS) = 0;
+        virtual void setRenderablesPointer(std::vector<std::shared_ptr<RenderObject>>* renderableObjects) = 0;
+        virtual void allocateDescriptorSetForTexture(std::string materialName, std::string name) = 0;
+        virtual void allocateDescriptorSetForSkybox() = 0;
+        virtual void setLightPointers(WorldLightObject* sceneLight, std::vector<WorldPointLightObject>* pointLights, std::vector<WorldSpotLightObject>* spotLights) = 0;
+        virtual void setCameraData(CameraData* camData) = 0;
+        virtual Mesh* getLoadedMesh(const std::string& name) = 0;
+        virtual void mapMaterialDataToGPU() = 0;
+        virtual void resetScene() = 0;
+        virtual void flushTextures() = 0;
+
+        //lander optics, each lander slot can have one image requested at a time, requests are drawn in the order they were made
+        virtual void setShouldDrawOffscreen(bool b, int landerSlot) = 0;
+        virtual bool isOpticsFramePending() = 0; //true from the request until the image is in flight to the cv queue
+        virtual std::vector<ImguiTexturePacket>& getDstTexturePackets() = 0;
+        virtual std::deque<int> getImguiTextureSetIndicesQueue() = 0;
+        virtual std::deque<int> getImguiDetectionIndicesQueue() = 0;
+        virtual std::deque<int> getImguiMatchIndicesQueue() = 0;
+        //finished images are queued per lander slot, so a lander that stops taking its images never holds up the others
+        virtual void popCvMatQueue(int landerSlot) = 0;
+        virtual cv::Mat& frontCvMatQueue(int landerSlot) = 0;
+        virtual bool cvMatQueueEmpty(int landerSlot) = 0;
+        virtual void clearCvMatQueue(int landerSlot) = 0; //drops every image waiting for that lander
+        virtual void assignMatToDetectionView(cv::Mat image) = 0;
+        virtual void assignMatToMatchingView(cv::Mat image) = 0;
+        virtual void clearOpticsViews() = 0;
+        virtual void setOpticsFov(float fov) = 0;
+
+        virtual ~IRenderEngine(){};
+};
@@ -0,0 +1,95 @@
+#include "sv_imageEncoder.h"
+#include "sv_trace.h"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include <iostream>
+
+Service::ImageEncoder::~ImageEncoder(){
+    stop();
+}
+
+void Service::ImageEncoder::start(ImageFormat imageFormat, int numThreads, size_t queueCapacity){
+    if(!threads.empty())
+        return;
+    format = imageFormat;
+    capacity = queueCapacity;
+    dropped = 0;
+    {
+        std::scoped_lock<std::mutex> lock(queueLock);
+        running = true;
+    }
+    for(int i = 0; i < numThreads; i++)
+        threads.emplace_back(&Service::ImageEncoder::workerLoop, this);
+}
+
+void Service::ImageEncoder::stop(){
+    if(threads.empty())
+        return;
+    {
+        std::scoped_lock<std::mutex> lock(queueLock);
+        running = false;
+    }
+    queueReady.notify_all();
+    for(std::thread& thread : threads)
+        thread.join();
+    threads.clear();
+
+    if(dropped > 0)
+        std::cout << dropped << " debug images dropped, encoder queue was full\n";
+}
+
+bool Service::ImageEncoder::enqueue(const std::string& path, cv::Mat image){
+    {
+        std::scoped_lock<std::mutex> lock(queueLock);
+        if(!running || queue.size() >= capacity){
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        queue.push_back(Job{path, std::move(image)});
+    }
+    queueReady.notify_one();
+    return true;
+}
+
+void Service::ImageEncoder::workerLoop(){
+    while(true){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queueLock);
+            queueReady.wait(lock, [this](){return !queue.empty() || !running;});
+            if(queue.empty())
+                return; //stopped and drained
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        encode(job.path, job.image, format);
+    }
+}
+
+void Service::ImageEncoder::encode(const std::string& path, const cv::Mat& image, ImageFormat format){
+    TRACE_ZONE("ImageEncoder::encode");
+    try{
+        switch(format){
+            case ImageFormat::Raw:{
+                if(image.channels() == 1){
+                    cv::imwrite(path + ".pgm", image);
+                    break;
+                }
+                cv::Mat bgr = image;
+                if(image.channels() == 4)
+                    cv::cvtColor(image, bgr, cv::COLOR_BGRA2BGR);
+                cv::imwrite(path + ".ppm", bgr);
+                break;
+            }
+            case ImageFormat::PngFast:
+                cv::imwrite(path + ".png", image, {cv::IMWRITE_PNG_COMPRESSION, 1});
+                break;
+            default:
+                cv::imwrite(path + ".jpg", image);
+                break;
+        }
+    }
+    catch (const cv::Exception &e){
+        std::cout << "Unable to write image " + path + ": " + e.what() + "\n";
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "opencv2/core.hpp"
+
+namespace Service{
+
+    enum class ImageFormat{
+        Raw, //uncompressed pgm/ppm, cheapest to write, alpha is dropped
+        PngFast, //lossless png at compression level 1
+        Jpeg //smallest, what the optics output always used
+    };
+
+    //encodes and writes debug images on a small pool of threads so vision never waits on imwrite
+    //the queue is bounded and enqueue never blocks, if the pool is behind the image is dropped and counted
+    //the mat is shared, not copied, so the caller must not write into it after handing it over
+    class ImageEncoder{
+        public:
+            ImageEncoder(){};
+            ~ImageEncoder();
+            ImageEncoder(const ImageEncoder&) = delete;
+            ImageEncoder& operator=(const ImageEncoder&) = delete;
+
+            void start(ImageFormat format, int numThreads, size_t capacity);
+            void stop(); //writes everything still queued, then joins the threads
+
+            //path without extension, the format's extension is added, returns false if the image was dropped
+            bool enqueue(const std::string& path, cv::Mat image);
+            uint64_t getDroppedCount(){return dropped.load(std::memory_order_relaxed);};
+
+            static void encode(const std::string& path, const cv::Mat& image, ImageFormat format); //on the calling thread
+
+        private:
+            struct Job{
+                std::string path;
+                cv::Mat image;
+            };
+
+            ImageFormat format = ImageFormat::Jpeg;
+            size_t capacity = 0;
+            std::mutex queueLock;
+            std::condition_variable queueReady;
+            std::deque<Job> queue;
+            std::vector<std::thread> threads;
+            bool running = false; //guarded by queueLock
+            std::atomic<uint64_t> dropped{0};
+
+            void workerLoop();
+    };
+}
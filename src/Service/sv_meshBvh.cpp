@@ -0,0 +1,206 @@
+#include "sv_meshBvh.h"
+#include "vk_mesh.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+void Service::MeshBvh::clear(){
+    nodes.clear();
+    triV0.clear(); triE1.clear(); triE2.clear();
+    triN0.clear(); triN1.clear(); triN2.clear();
+}
+
+void Service::MeshBvh::build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexBase, uint32_t indexCount){
+    clear();
+    uint32_t triangleCount = indexCount/3;
+    if(triangleCount == 0)
+        return;
+
+    order.resize(triangleCount);
+    centroids.resize(triangleCount);
+    boundsMin.resize(triangleCount);
+    boundsMax.resize(triangleCount);
+    for(uint32_t i = 0; i < triangleCount; i++){
+        const glm::vec3& a = vertices[indices[indexBase+i*3]].pos;
+        const glm::vec3& b = vertices[indices[indexBase+i*3+1]].pos;
+        const glm::vec3& c = vertices[indices[indexBase+i*3+2]].pos;
+        order[i] = i;
+        boundsMin[i] = glm::min(a, glm::min(b, c));
+        boundsMax[i] = glm::max(a, glm::max(b, c));
+        centroids[i] = (boundsMin[i]+boundsMax[i])*0.5f;
+    }
+
+    nodes.reserve(triangleCount/2+1);
+    buildNode(0, triangleCount);
+
+    //store triangles in leaf order so leaves read contiguous memory
+    triV0.resize(triangleCount); triE1.resize(triangleCount); triE2.resize(triangleCount);
+    triN0.resize(triangleCount); triN1.resize(triangleCount); triN2.resize(triangleCount);
+    for(uint32_t i = 0; i < triangleCount; i++){
+        const Vertex& a = vertices[indices[indexBase+order[i]*3]];
+        const Vertex& b = vertices[indices[indexBase+order[i]*3+1]];
+        const Vertex& c = vertices[indices[indexBase+order[i]*3+2]];
+        triV0[i] = a.pos;
+        triE1[i] = b.pos-a.pos;
+        triE2[i] = c.pos-a.pos;
+        triN0[i] = a.normal;
+        triN1[i] = b.normal;
+        triN2[i] = c.normal;
+    }
+
+    order.clear(); order.shrink_to_fit();
+    centroids.clear(); centroids.shrink_to_fit();
+    boundsMin.clear(); boundsMin.shrink_to_fit();
+    boundsMax.clear(); boundsMax.shrink_to_fit();
+}
+
+//median split on the longest axis of the centroid bounds
+uint32_t Service::MeshBvh::splitRange(uint32_t begin, uint32_t end){
+    glm::vec3 cMin = centroids[order[begin]];
+    glm::vec3 cMax = cMin;
+    for(uint32_t i = begin+1; i < end; i++){
+        cMin = glm::min(cMin, centroids[order[i]]);
+        cMax = glm::max(cMax, centroids[order[i]]);
+    }
+    glm::vec3 extent = cMax-cMin;
+    int axis = 0;
+    if(extent.y > extent.x) axis = 1;
+    if(extent.z > extent[axis]) axis = 2;
+
+    uint32_t mid = begin+(end-begin)/2;
+    std::nth_element(order.begin()+begin, order.begin()+mid, order.begin()+end, [&](uint32_t a, uint32_t b){
+        return centroids[a][axis] < centroids[b][axis];
+    });
+    return mid;
+}
+
+//splits the range in two, then each half in two again, giving up to 4 children per node
+int32_t Service::MeshBvh::buildNode(uint32_t begin, uint32_t end){
+    int32_t nodeIndex = nodes.size();
+    nodes.emplace_back();
+
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    if(end-begin <= MAX_LEAF_TRIANGLES){
+        ranges.push_back({begin, end});
+    }
+    else{
+        uint32_t mid = splitRange(begin, end);
+        for(std::pair<uint32_t, uint32_t> half : {std::make_pair(begin, mid), std::make_pair(mid, end)}){
+            if(half.second-half.first > MAX_LEAF_TRIANGLES){
+                uint32_t quarter = splitRange(half.first, half.second);
+                ranges.push_back({half.first, quarter});
+                ranges.push_back({quarter, half.second});
+            }
+            else
+                ranges.push_back(half);
+        }
+    }
+
+    for(int lane = 0; lane < 4; lane++){
+        Node& node = nodes[nodeIndex];
+        node.child[lane] = -1;
+        node.count[lane] = 0;
+        node.minX[lane] = node.minY[lane] = node.minZ[lane] = 0;
+        node.maxX[lane] = node.maxY[lane] = node.maxZ[lane] = 0;
+        if(lane >= (int)ranges.size())
+            continue;
+
+        uint32_t rBegin = ranges[lane].first;
+        uint32_t rEnd = ranges[lane].second;
+        glm::vec3 bMin = boundsMin[order[rBegin]];
+        glm::vec3 bMax = boundsMax[order[rBegin]];
+        for(uint32_t i = rBegin+1; i < rEnd; i++){
+            bMin = glm::min(bMin, boundsMin[order[i]]);
+            bMax = glm::max(bMax, boundsMax[order[i]]);
+        }
+        node.minX[lane] = bMin.x; node.minY[lane] = bMin.y; node.minZ[lane] = bMin.z;
+        node.maxX[lane] = bMax.x; node.maxY[lane] = bMax.y; node.maxZ[lane] = bMax.z;
+
+        if(rEnd-rBegin <= MAX_LEAF_TRIANGLES){
+            node.child[lane] = rBegin;
+            node.count[lane] = rEnd-rBegin;
+        }
+        else{
+            int32_t child = buildNode(rBegin, rEnd); //may reallocate nodes, so node is not used after this
+            nodes[nodeIndex].child[lane] = child;
+        }
+    }
+    return nodeIndex;
+}
+
+bool Service::MeshBvh::intersect(const glm::vec3& origin, const glm::vec3& dir, float tMin, float tMax, RayHit& hit) const{
+    if(nodes.empty())
+        return false;
+
+    const float inf = std::numeric_limits<float>::infinity();
+    glm::vec3 invDir;
+    for(int i = 0; i < 3; i++)
+        invDir[i] = dir[i] != 0.0f ? 1.0f/dir[i] : inf;
+
+    bool found = false;
+    float closest = tMax;
+
+    int32_t stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while(stackSize > 0){
+        const Node& node = nodes[stack[--stackSize]];
+
+        //slab test each of the 4 children
+        float tNear[4];
+        bool laneHit[4];
+        for(int lane = 0; lane < 4; lane++){
+            float tx0 = (node.minX[lane]-origin.x)*invDir.x, tx1 = (node.maxX[lane]-origin.x)*invDir.x;
+            float ty0 = (node.minY[lane]-origin.y)*invDir.y, ty1 = (node.maxY[lane]-origin.y)*invDir.y;
+            float tz0 = (node.minZ[lane]-origin.z)*invDir.z, tz1 = (node.maxZ[lane]-origin.z)*invDir.z;
+            float t0 = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), tMin));
+            float t1 = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), closest));
+            tNear[lane] = t0;
+            laneHit[lane] = node.child[lane] >= 0 && t0 <= t1;
+        }
+
+        //leaves are tested straight away, inner nodes are pushed furthest first so the nearest is popped next
+        int innerLanes[4];
+        int innerCount = 0;
+        for(int lane = 0; lane < 4; lane++){
+            if(!laneHit[lane])
+                continue;
+            if(node.count[lane] == 0){
+                innerLanes[innerCount++] = lane;
+                continue;
+            }
+            uint32_t first = node.child[lane];
+            for(uint32_t tri = first; tri < first+node.count[lane]; tri++){
+                //Moller-Trumbore, two sided
+                glm::vec3 p = glm::cross(dir, triE2[tri]);
+                float det = glm::dot(triE1[tri], p);
+                if(std::abs(det) < 1e-12f)
+                    continue;
+                float invDet = 1.0f/det;
+                glm::vec3 s = origin-triV0[tri];
+                float u = glm::dot(s, p)*invDet;
+                if(u < 0.0f || u > 1.0f)
+                    continue;
+                glm::vec3 q = glm::cross(s, triE1[tri]);
+                float v = glm::dot(dir, q)*invDet;
+                if(v < 0.0f || u+v > 1.0f)
+                    continue;
+                float t = glm::dot(triE2[tri], q)*invDet;
+                if(t < tMin || t > closest)
+                    continue;
+                closest = t;
+                hit = {t, tri, u, v};
+                found = true;
+            }
+        }
+        std::sort(innerLanes, innerLanes+innerCount, [&](int a, int b){return tNear[a] > tNear[b];});
+        for(int i = 0; i < innerCount; i++)
+            stack[stackSize++] = node.child[innerLanes[i]];
+    }
+    return found;
+}
+
+glm::vec3 Service::MeshBvh::getNormal(const RayHit& hit) const{
+    return triN0[hit.triangle]*(1.0f-hit.u-hit.v) + triN1[hit.triangle]*hit.u + triN2[hit.triangle]*hit.v;
+}
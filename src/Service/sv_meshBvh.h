@@ -0,0 +1,54 @@
+#pragma once
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+struct Vertex; //defined in vk_mesh.h
+
+namespace Service{
+
+//result of a ray query against a MeshBvh, u and v are barycentric coords of the hit on the triangle
+struct RayHit{
+    float t;
+    uint32_t triangle;
+    float u, v;
+};
+
+//4 wide bounding volume hierarchy over one mesh in the shared vertex/index arrays, built in model space
+//child bounds are stored as arrays of 4 so a node's slab tests read them in one pass, rays are still traced one at a time
+//build once per mesh, the caller transforms rays into model space so rotating objects dont need a rebuild
+class MeshBvh{
+    public:
+        void build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexBase, uint32_t indexCount);
+        void clear();
+        bool empty() const {return nodes.empty();};
+        //closest hit along origin + t*dir with tMin <= t <= tMax, dir doesnt need to be normalised
+        bool intersect(const glm::vec3& origin, const glm::vec3& dir, float tMin, float tMax, RayHit& hit) const;
+        glm::vec3 getNormal(const RayHit& hit) const; //interpolated vertex normal at the hit, model space, not normalised
+    private:
+        static const uint32_t MAX_LEAF_TRIANGLES = 4;
+
+        //a lane is empty if child < 0, a leaf if count > 0 (child is the first triangle), otherwise child is a node index
+        struct Node{
+            float minX[4], minY[4], minZ[4];
+            float maxX[4], maxY[4], maxZ[4];
+            int32_t child[4];
+            uint32_t count[4];
+        };
+        std::vector<Node> nodes;
+
+        //triangle data in leaf order, edges precomputed for the intersection test
+        std::vector<glm::vec3> triV0, triE1, triE2;
+        std::vector<glm::vec3> triN0, triN1, triN2;
+
+        //build scratch, triangle ids are sorted in place while building
+        std::vector<uint32_t> order;
+        std::vector<glm::vec3> centroids;
+        std::vector<glm::vec3> boundsMin, boundsMax;
+
+        int32_t buildNode(uint32_t begin, uint32_t end);
+        uint32_t splitRange(uint32_t begin, uint32_t end);
+};
+}
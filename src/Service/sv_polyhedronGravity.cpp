@@ -0,0 +1,157 @@
+#include "sv_polyhedronGravity.h"
+#include "vk_mesh.h"
+#include <map>
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+void Service::PolyhedronGravity::build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexBase, uint32_t indexCount, const glm::vec3& scale){
+    //weld by position, the render mesh splits vertices wherever the normal or uv changes
+    std::map<std::array<float, 3>, uint32_t> welded;
+    std::vector<glm::dvec3> corners;
+    std::vector<std::array<uint32_t, 3>> faces;
+    for(uint32_t i = indexBase; i + 2 < indexBase + indexCount; i += 3){
+        std::array<uint32_t, 3> face;
+        for(int k = 0; k < 3; k++){
+            glm::vec3 pos = vertices[indices[i+k]].pos*scale;
+            auto [it, added] = welded.try_emplace({pos.x, pos.y, pos.z}, corners.size());
+            if(added)
+                corners.push_back(glm::dvec3(pos));
+            face[k] = it->second;
+        }
+        if(face[0] != face[1] && face[1] != face[2] && face[2] != face[0]) //drop triangles collapsed by the weld
+            faces.push_back(face);
+    }
+
+    //divergence theorem volume, negative if the faces wind inwards
+    volume = 0;
+    for(const auto& face : faces)
+        volume += glm::dot(corners[face[0]], glm::cross(corners[face[1]], corners[face[2]]))/6.0;
+    if(volume < 0){
+        for(auto& face : faces)
+            std::swap(face[1], face[2]);
+        volume = -volume;
+    }
+    boundingRadius = 0;
+    for(const glm::dvec3& corner : corners)
+        boundingRadius = std::max(boundingRadius, glm::length(corner));
+
+    faceCount = faces.size();
+    for(std::vector<double>* array : {&fX1, &fY1, &fZ1, &fX2, &fY2, &fZ2, &fX3, &fY3, &fZ3, &fXX, &fXY, &fXZ, &fYY, &fYZ, &fZZ})
+        array->resize(faceCount);
+
+    //each edge sums n*ne^T over the faces that use it, ne is the edge normal in the face's plane pointing out of the face
+    std::map<std::pair<uint32_t, uint32_t>, std::pair<glm::dmat3, int>> edges;
+    for(size_t f = 0; f < faceCount; f++){
+        const glm::dvec3& v1 = corners[faces[f][0]];
+        const glm::dvec3& v2 = corners[faces[f][1]];
+        const glm::dvec3& v3 = corners[faces[f][2]];
+        glm::dvec3 n = glm::normalize(glm::cross(v2 - v1, v3 - v1));
+        fX1[f] = v1.x; fY1[f] = v1.y; fZ1[f] = v1.z;
+        fX2[f] = v2.x; fY2[f] = v2.y; fZ2[f] = v2.z;
+        fX3[f] = v3.x; fY3[f] = v3.y; fZ3[f] = v3.z;
+        fXX[f] = n.x*n.x; fXY[f] = n.x*n.y; fXZ[f] = n.x*n.z;
+        fYY[f] = n.y*n.y; fYZ[f] = n.y*n.z; fZZ[f] = n.z*n.z;
+
+        for(int k = 0; k < 3; k++){
+            uint32_t a = faces[f][k], b = faces[f][(k+1)%3];
+            glm::dvec3 edgeNormal = glm::normalize(glm::cross(corners[b] - corners[a], n));
+            auto& edge = edges.try_emplace({std::min(a, b), std::max(a, b)}, glm::dmat3(0.0), 0).first->second;
+            edge.first += glm::outerProduct(n, edgeNormal); //n*ne^T, glm stores it column major
+            edge.second++;
+        }
+    }
+
+    edgeCount = edges.size();
+    for(std::vector<double>* array : {&eXA, &eYA, &eZA, &eXB, &eYB, &eZB, &eLength, &eXX, &eXY, &eXZ, &eYX, &eYY, &eYZ, &eZX, &eZY, &eZZ})
+        array->resize(edgeCount);
+    openEdgeCount = 0;
+    size_t e = 0;
+    for(const auto& [key, edge] : edges){
+        const glm::dvec3& a = corners[key.first];
+        const glm::dvec3& b = corners[key.second];
+        const glm::dmat3& E = edge.first;
+        if(edge.second != 2)
+            openEdgeCount++;
+        eXA[e] = a.x; eYA[e] = a.y; eZA[e] = a.z;
+        eXB[e] = b.x; eYB[e] = b.y; eZB[e] = b.z;
+        eLength[e] = glm::length(b - a);
+        eXX[e] = E[0][0]; eXY[e] = E[1][0]; eXZ[e] = E[2][0]; //E[column][row]
+        eYX[e] = E[0][1]; eYY[e] = E[1][1]; eYZ[e] = E[2][1];
+        eZX[e] = E[0][2]; eZY[e] = E[1][2]; eZZ[e] = E[2][2];
+        e++;
+    }
+}
+
+//g = -G*rho*sum(E_e*r_e*L_e) + G*rho*sum(F_f*r_f*w_f), r runs from the field point to the edge or face
+//both loops are omp simd, built with -fopenmp-simd -ffast-math (see src/CMakeLists.txt) so gcc calls glibc's libmvec
+//packet log and atan2 (_ZGV*_log, _ZGV*_atan2) instead of a scalar libm call per lane, check with -fopt-info-vec
+glm::dvec3 Service::PolyhedronGravity::evaluate(const glm::dvec3& point) const{
+    const double px = point.x, py = point.y, pz = point.z;
+    double gx = 0, gy = 0, gz = 0;
+
+    #pragma omp simd reduction(+:gx, gy, gz)
+    for(size_t i = 0; i < edgeCount; i++){
+        double ax = eXA[i]-px, ay = eYA[i]-py, az = eZA[i]-pz;
+        double bx = eXB[i]-px, by = eYB[i]-py, bz = eZB[i]-pz;
+        double a = std::sqrt(ax*ax + ay*ay + az*az);
+        double b = std::sqrt(bx*bx + by*by + bz*bz);
+        double L = std::log((a + b + eLength[i])/std::max(a + b - eLength[i], 1e-12)); //only singular on the edge itself
+        gx -= (eXX[i]*ax + eXY[i]*ay + eXZ[i]*az)*L;
+        gy -= (eYX[i]*ax + eYY[i]*ay + eYZ[i]*az)*L;
+        gz -= (eZX[i]*ax + eZY[i]*ay + eZZ[i]*az)*L;
+    }
+
+    #pragma omp simd reduction(+:gx, gy, gz)
+    for(size_t i = 0; i < faceCount; i++){
+        double x1 = fX1[i]-px, y1 = fY1[i]-py, z1 = fZ1[i]-pz;
+        double x2 = fX2[i]-px, y2 = fY2[i]-py, z2 = fZ2[i]-pz;
+        double x3 = fX3[i]-px, y3 = fY3[i]-py, z3 = fZ3[i]-pz;
+        double l1 = std::sqrt(x1*x1 + y1*y1 + z1*z1);
+        double l2 = std::sqrt(x2*x2 + y2*y2 + z2*z2);
+        double l3 = std::sqrt(x3*x3 + y3*y3 + z3*z3);
+        //solid angle the face subtends at the point
+        double triple = x1*(y2*z3 - z2*y3) + y1*(z2*x3 - x2*z3) + z1*(x2*y3 - y2*x3);
+        double denom = l1*l2*l3 + l1*(x2*x3 + y2*y3 + z2*z3) + l2*(x3*x1 + y3*y1 + z3*z1) + l3*(x1*x2 + y1*y2 + z1*z2);
+        double w = 2.0*std::atan2(triple, denom);
+        gx += (fXX[i]*x1 + fXY[i]*y1 + fXZ[i]*z1)*w;
+        gy += (fXY[i]*x1 + fYY[i]*y1 + fYZ[i]*z1)*w;
+        gz += (fXZ[i]*x1 + fYZ[i]*y1 + fZZ[i]*z1)*w;
+    }
+    return densityConstant*glm::dvec3(gx, gy, gz);
+}
+
+//---------------------------------------------------------------- field cache
+
+Service::GravityFieldCache::GravityFieldCache(std::shared_ptr<const PolyhedronGravity> model): p_model{model}{
+    baseCellSize = std::max(p_model->getBoundingRadius(), 1e-6)/CELLS_PER_RADIUS;
+}
+
+const glm::dvec3& Service::GravityFieldCache::getNode(int level, int64_t x, int64_t y, int64_t z){
+    //grid indices stay within about +-2*CELLS_PER_RADIUS on every level, 16 bits each is plenty
+    uint64_t key = (uint64_t)level << 48 | (uint64_t)(x + 32768) << 32 | (uint64_t)(y + 32768) << 16 | (uint64_t)(z + 32768);
+    auto it = nodes.find(key);
+    if(it != nodes.end())
+        return it->second;
+    double cell = std::ldexp(baseCellSize, level);
+    return nodes.emplace(key, p_model->evaluate(glm::dvec3(x, y, z)*cell)).first->second;
+}
+
+glm::dvec3 Service::GravityFieldCache::sample(const glm::dvec3& point){
+    double distance = glm::length(point);
+    int level = 0;
+    if(distance > p_model->getBoundingRadius())
+        level = std::min(MAX_LEVEL, (int)std::floor(std::log2(distance/p_model->getBoundingRadius())));
+    double cell = std::ldexp(baseCellSize, level);
+
+    glm::dvec3 grid = point/cell;
+    glm::dvec3 base = glm::floor(grid);
+    glm::dvec3 t = grid - base;
+    int64_t x = base.x, y = base.y, z = base.z;
+
+    glm::dvec3 c00 = glm::mix(getNode(level, x, y, z), getNode(level, x+1, y, z), t.x);
+    glm::dvec3 c10 = glm::mix(getNode(level, x, y+1, z), getNode(level, x+1, y+1, z), t.x);
+    glm::dvec3 c01 = glm::mix(getNode(level, x, y, z+1), getNode(level, x+1, y, z+1), t.x);
+    glm::dvec3 c11 = glm::mix(getNode(level, x, y+1, z+1), getNode(level, x+1, y+1, z+1), t.x);
+    return glm::mix(glm::mix(c00, c10, t.y), glm::mix(c01, c11, t.y), t.z);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+struct Vertex; //defined in vk_mesh.h
+
+namespace Service{
+
+//constant density polyhedron gravity (Werner and Scheeres 1997) of one mesh in the shared vertex/index arrays, model space
+//vertices are welded by position so uv seams dont open edges, faces are flipped if the mesh winds inwards
+//face dyads n*n^T and edge dyads nA*nA12^T + nB*nB21^T are worked out once on build
+//faces and edges are stored as flat arrays with their corners copied in, so evaluate is straight omp simd loops with no gathers
+//an edge with only one face (open mesh) keeps just that face's half of its dyad, the field is then approximate
+class PolyhedronGravity{
+    public:
+        void build(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, uint32_t indexBase, uint32_t indexCount, const glm::vec3& scale);
+        bool empty() const {return faceCount == 0;};
+        void setDensityConstant(double gDensity){densityConstant = gDensity;}; //G times density, scales the whole field
+        glm::dvec3 evaluate(const glm::dvec3& point) const; //acceleration at point, model space, valid inside and outside the body
+
+        double getVolume() const {return volume;};
+        double getBoundingRadius() const {return boundingRadius;}; //furthest vertex from the model origin
+        size_t getOpenEdgeCount() const {return openEdgeCount;};
+    private:
+        double densityConstant = 1.0;
+        double volume = 0;
+        double boundingRadius = 0;
+        size_t openEdgeCount = 0;
+
+        //faces, corners and the symmetric dyad n*n^T
+        size_t faceCount = 0;
+        std::vector<double> fX1, fY1, fZ1, fX2, fY2, fZ2, fX3, fY3, fZ3;
+        std::vector<double> fXX, fXY, fXZ, fYY, fYZ, fZZ;
+
+        //edges, end points, length and the full dyad (not symmetric for a single edge)
+        size_t edgeCount = 0;
+        std::vector<double> eXA, eYA, eZA, eXB, eYB, eZB, eLength;
+        std::vector<double> eXX, eXY, eXZ, eYX, eYY, eYZ, eZX, eZY, eZZ;
+};
+
+//lazily filled trilinear cache of a PolyhedronGravity field, model space
+//nodes sit on nested grids, level l covers |p| up to boundingRadius*2^(l+1) with cells CELLS_PER_RADIUS times finer than that radius
+//so the interpolation error relative to the field stays about the same at any distance
+//a node is evaluated exactly the first time a lookup needs it and kept for the rest of the run, nodes are a pure function of position
+//so runs stay reproducible, not thread safe, one cache per scene
+class GravityFieldCache{
+    public:
+        GravityFieldCache(std::shared_ptr<const PolyhedronGravity> model);
+        glm::dvec3 sample(const glm::dvec3& point);
+        size_t getNodeCount(){return nodes.size();};
+    private:
+        static constexpr double CELLS_PER_RADIUS = 16.0;
+        static const int MAX_LEVEL = 30;
+
+        std::shared_ptr<const PolyhedronGravity> p_model;
+        double baseCellSize;
+        std::unordered_map<uint64_t, glm::dvec3> nodes;
+
+        const glm::dvec3& getNode(int level, int64_t x, int64_t y, int64_t z);
+};
+}
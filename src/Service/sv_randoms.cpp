@@ -4,6 +4,7 @@
 #include <LinearMath/btVector3.h>
 #include <random>
 #include <iomanip> //used for setprecision in random function
+#include <algorithm>
 
 #define GLM_FORCE_RADIANS                  //makes sure GLM uses radians to avoid confusion
 #define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES //forces GLM to use a version of vec2 and mat4 that have the correct alignment requirements for Vulkan
@@ -24,20 +25,48 @@ btVector3 Service::getPointOnSphere(float pitch, float yaw, float radius)
 }
 
 //helper, gets random float between min and max
-float Service::getRandFloat(float min, float max)
+float Service::getRandFloat(RandomStream& rng, float min, float max)
 {
-    float offset = 0.0f;
-    if (min < 0)
-    {
-        offset = -min;
-        min = 0;
-        max += offset;
+    return min + rng.nextFloat()*(max-min);
+}
+
+Service::RandomStream::RandomStream(uint64_t iseed, uint32_t istreamId): seed{iseed}, streamId{istreamId}{}
+
+//Philox4x32-10, see Salmon et al. "Parallel random numbers: as easy as 1, 2, 3"
+//counter is {block lo, block hi, stream id, 0}, key is the seed
+void Service::RandomStream::generateBlock(){
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    uint32_t ctr[4] = {(uint32_t)blockCounter, (uint32_t)(blockCounter >> 32), streamId, 0};
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    for(int round = 0; round < 10; round++){
+        uint64_t p0 = (uint64_t)M0 * ctr[0];
+        uint64_t p1 = (uint64_t)M1 * ctr[2];
+        uint32_t next[4] = {(uint32_t)(p1 >> 32) ^ ctr[1] ^ key[0], (uint32_t)p1, (uint32_t)(p0 >> 32) ^ ctr[3] ^ key[1], (uint32_t)p0};
+        std::copy(next, next+4, ctr);
+        key[0] += W0;
+        key[1] += W1;
     }
+    std::copy(ctr, ctr+4, block);
+    blockCounter++;
+    blockIndex = 0;
+}
+
+uint32_t Service::RandomStream::nextUint(){
+    if(blockIndex >= 4)
+        generateBlock();
+    return block[blockIndex++];
+}
+
+//top 24 bits so every value is exactly representable as a float and the result never rounds up to 1
+float Service::RandomStream::nextFloat(){
+    return (nextUint() >> 8) * (1.0f/16777216.0f);
+}
+
+uint64_t Service::getFreshSeed(){
     std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<> distr(min, max);
-    float result = distr(eng) - offset;
-    return result;
+    uint64_t seed = ((uint64_t)rd() << 32) | rd();
+    return seed == 0 ? 1 : seed; //0 is reserved for "pick a seed"
 }
 
 float Service::getAbsMax(float a, float b){
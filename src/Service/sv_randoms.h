@@ -2,14 +2,43 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <opencv2/opencv.hpp>
+#include <cstdint>
 class btVector3;
 class btMatrix3x3;
 class btTransform;
 class btQuaternion;
 
 namespace Service{
+    //stream ids, each consumer of randomness in a run draws from its own stream so adding draws in one place doesnt shift the others
+    enum RandomStreamId{
+        RNG_STREAM_SCENARIO = 0, //scenario randomisation in MyScene, asteroid rotation etc
+        RNG_STREAM_LANDER = 1, //lander initial velocity direction
+        RNG_STREAM_LIDAR = 2, //lidar range noise
+        RNG_STREAM_LANDER_FLEET = 1000, //same for the secondary landers in a multi lander scene, each uses this plus its slot
+        RNG_STREAM_LIDAR_FLEET = 2000
+    };
+
+    //counter based generator (Philox4x32-10), output is a pure function of seed, stream and counter
+    //every run owns its own streams so parallel campaign workers never share state, and any run can be replayed from its seed
+    class RandomStream{
+        public:
+            RandomStream(uint64_t seed = 0, uint32_t streamId = 0);
+            uint32_t nextUint();
+            float nextFloat(); //uniform in [0,1)
+            uint64_t getSeed(){return seed;};
+        private:
+            uint64_t seed;
+            uint32_t streamId;
+            uint64_t blockCounter = 0; //index of the next 128 bit block
+            uint32_t block[4];
+            int blockIndex = 4; //next unused word in block, 4 means generate a new block
+            void generateBlock();
+    };
+
+    uint64_t getFreshSeed(); //nondeterministic seed from random_device, used when a scenario doesnt specify one
+
     btVector3 getPointOnSphere(float pitch, float yaw, float radius); //helper, gets point on sphere of given radius, origin 0
-    float getRandFloat(float min, float max); //helper, gets random float between min and max
+    float getRandFloat(RandomStream& rng, float min, float max); //helper, gets random float between min and max
 
     btVector3 glm2bt(const glm::vec3& vec);
 
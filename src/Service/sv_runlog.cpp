@@ -0,0 +1,281 @@
+#include "sv_runlog.h"
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+size_t Service::runLogBlockBytes(uint32_t blockRows, uint8_t numValues){
+    size_t bytes = sizeof(RunLogBlockHeader) + blockRows*(sizeof(double) + sizeof(uint64_t)) + static_cast<size_t>(numValues)*blockRows*sizeof(float);
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+//---------------------------------------------------------------- writer
+
+Service::RunLogWriter::RunLogWriter(){
+    currentBlock.fill(-1);
+}
+
+Service::RunLogWriter::~RunLogWriter(){
+    close();
+}
+
+bool Service::RunLogWriter::open(const std::string& path){
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0){
+        std::cout << "Unable to open run log " + path + "\n";
+        return false;
+    }
+    used = 0;
+    if(!reserve(sizeof(RunLogFileHeader))){
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    RunLogFileHeader header;
+    std::memcpy(header.magic, RUNLOG_MAGIC, sizeof(header.magic));
+    header.version = RUNLOG_VERSION;
+    header.blockRows = RUNLOG_BLOCK_ROWS;
+    std::memcpy(mapped, &header, sizeof(header));
+    used = sizeof(header);
+    currentBlock.fill(-1);
+    blockOffsets.clear();
+    nextSequence = 0;
+    return true;
+}
+
+//the file is grown with ftruncate so new pages read back as zero, which is what ends a block scan after a crash
+bool Service::RunLogWriter::reserve(size_t bytes){
+    if(used + bytes <= mappedSize)
+        return true;
+
+    size_t newSize = std::max(mappedSize + RUNLOG_GROW_BYTES, used + bytes);
+    if(mapped != nullptr)
+        munmap(mapped, mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+
+    if(ftruncate(fd, newSize) != 0){
+        std::cout << "Unable to grow run log\n";
+        return false;
+    }
+    void* address = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(address == MAP_FAILED){
+        std::cout << "Unable to map run log\n";
+        return false;
+    }
+    mapped = static_cast<char*>(address);
+    mappedSize = newSize;
+    return true;
+}
+
+int64_t Service::RunLogWriter::startBlock(TelemetryChannel channel){
+    uint8_t numValues = TELEMETRY_CHANNELS[channel].numValues;
+    size_t size = runLogBlockBytes(RUNLOG_BLOCK_ROWS, numValues);
+    if(!reserve(size))
+        return -1;
+
+    int64_t offset = used;
+    RunLogBlockHeader* block = reinterpret_cast<RunLogBlockHeader*>(mapped + offset);
+    block->channel = channel;
+    block->numValues = numValues;
+    block->rows = 0;
+    block->minTime = 0;
+    block->maxTime = 0;
+    block->marker = RUNLOG_BLOCK_MARKER;
+
+    used += size;
+    blockOffsets.push_back(offset);
+    currentBlock[channel] = offset;
+    return offset;
+}
+
+void Service::RunLogWriter::append(const TelemetryRecord& record){
+    if(fd < 0 || mapped == nullptr || record.channel >= NUM_TELEMETRY_CHANNELS)
+        return;
+
+    int64_t offset = currentBlock[record.channel];
+    if(offset < 0 || reinterpret_cast<RunLogBlockHeader*>(mapped + offset)->rows == RUNLOG_BLOCK_ROWS)
+        offset = startBlock(record.channel);
+    if(offset < 0)
+        return;
+
+    RunLogBlockHeader* block = reinterpret_cast<RunLogBlockHeader*>(mapped + offset);
+    uint32_t row = block->rows;
+    double* timestamps = reinterpret_cast<double*>(mapped + offset + sizeof(RunLogBlockHeader));
+    uint64_t* sequence = reinterpret_cast<uint64_t*>(timestamps + RUNLOG_BLOCK_ROWS);
+    float* columns = reinterpret_cast<float*>(sequence + RUNLOG_BLOCK_ROWS);
+    timestamps[row] = record.timestamp;
+    sequence[row] = nextSequence++;
+    for(int i = 0; i < block->numValues; i++)
+        columns[i*RUNLOG_BLOCK_ROWS + row] = record.values[i];
+
+    if(row == 0 || record.timestamp < block->minTime)
+        block->minTime = record.timestamp;
+    if(row == 0 || record.timestamp > block->maxTime)
+        block->maxTime = record.timestamp;
+    block->rows = row + 1;
+}
+
+void Service::RunLogWriter::sync(){
+    if(mapped != nullptr)
+        msync(mapped, mappedSize, MS_ASYNC);
+}
+
+void Service::RunLogWriter::close(){
+    if(fd < 0)
+        return;
+
+    size_t finalSize = used;
+    size_t footerBytes = blockOffsets.size()*sizeof(RunLogIndexEntry) + sizeof(RunLogTrailer);
+    if(mapped != nullptr && reserve(footerBytes)){
+        char* footer = mapped + used;
+        for(uint64_t offset : blockOffsets){
+            RunLogIndexEntry entry;
+            entry.offset = offset;
+            std::memcpy(&entry.block, mapped + offset, sizeof(RunLogBlockHeader));
+            std::memcpy(footer, &entry, sizeof(entry));
+            footer += sizeof(entry);
+        }
+        RunLogTrailer trailer;
+        trailer.indexOffset = used;
+        trailer.numBlocks = blockOffsets.size();
+        std::memcpy(trailer.magic, RUNLOG_TRAILER_MAGIC, sizeof(trailer.magic));
+        std::memcpy(footer, &trailer, sizeof(trailer));
+        finalSize = used + footerBytes;
+    }
+
+    if(mapped != nullptr)
+        munmap(mapped, mappedSize);
+    if(ftruncate(fd, finalSize) != 0)
+        std::cout << "Unable to trim run log\n";
+    ::close(fd);
+
+    fd = -1;
+    mapped = nullptr;
+    mappedSize = 0;
+    used = 0;
+    currentBlock.fill(-1);
+    blockOffsets.clear();
+}
+
+//---------------------------------------------------------------- reader
+
+Service::RunLogReader::~RunLogReader(){
+    close();
+}
+
+bool Service::RunLogReader::open(const std::string& path){
+    close();
+    fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RunLogFileHeader)){
+        close();
+        return false;
+    }
+    void* address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(address == MAP_FAILED){
+        close();
+        return false;
+    }
+    mapped = static_cast<const char*>(address);
+    mappedSize = info.st_size;
+
+    RunLogFileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    if(std::memcmp(header.magic, RUNLOG_MAGIC, sizeof(header.magic)) != 0 || header.version != RUNLOG_VERSION || header.blockRows == 0){
+        close();
+        return false;
+    }
+    blockRows = header.blockRows;
+
+    indexed = readIndex();
+    if(!indexed)
+        scanBlocks();
+    return true;
+}
+
+void Service::RunLogReader::close(){
+    if(mapped != nullptr)
+        munmap(const_cast<char*>(mapped), mappedSize);
+    if(fd >= 0)
+        ::close(fd);
+    fd = -1;
+    mapped = nullptr;
+    mappedSize = 0;
+    blockRows = 0;
+    indexed = false;
+    blocks.clear();
+}
+
+bool Service::RunLogReader::readIndex(){
+    if(mappedSize < sizeof(RunLogFileHeader) + sizeof(RunLogTrailer))
+        return false;
+
+    RunLogTrailer trailer;
+    std::memcpy(&trailer, mapped + mappedSize - sizeof(trailer), sizeof(trailer));
+    if(std::memcmp(trailer.magic, RUNLOG_TRAILER_MAGIC, sizeof(trailer.magic)) != 0)
+        return false;
+    if(trailer.indexOffset < sizeof(RunLogFileHeader) || trailer.numBlocks > mappedSize/sizeof(RunLogIndexEntry)
+       || trailer.indexOffset + trailer.numBlocks*sizeof(RunLogIndexEntry) + sizeof(RunLogTrailer) != mappedSize)
+        return false;
+
+    blocks.resize(trailer.numBlocks);
+    std::memcpy(blocks.data(), mapped + trailer.indexOffset, trailer.numBlocks*sizeof(RunLogIndexEntry));
+    for(const RunLogIndexEntry& entry : blocks){
+        if(entry.offset + runLogBlockBytes(blockRows, entry.block.numValues) > trailer.indexOffset || entry.block.rows > blockRows){
+            blocks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+//walks the blocks from the start of the file until one is missing its marker or runs past the end
+void Service::RunLogReader::scanBlocks(){
+    size_t offset = sizeof(RunLogFileHeader);
+    while(offset + sizeof(RunLogBlockHeader) <= mappedSize){
+        RunLogIndexEntry entry;
+        entry.offset = offset;
+        std::memcpy(&entry.block, mapped + offset, sizeof(RunLogBlockHeader));
+        size_t size = runLogBlockBytes(blockRows, entry.block.numValues);
+        if(entry.block.marker != RUNLOG_BLOCK_MARKER || entry.block.rows > blockRows || offset + size > mappedSize)
+            break;
+        blocks.push_back(entry);
+        offset += size;
+    }
+}
+
+size_t Service::RunLogReader::query(TelemetryChannel channel, double from, double to, const std::function<void(const TelemetryRecord&, uint64_t sequence)>& visit){
+    size_t visited = 0;
+    TelemetryRecord record = {};
+    record.channel = channel;
+    for(const RunLogIndexEntry& entry : blocks){
+        const RunLogBlockHeader& block = entry.block;
+        if(block.channel != channel || block.rows == 0 || block.maxTime < from || block.minTime > to)
+            continue;
+
+        const double* timestamps = reinterpret_cast<const double*>(mapped + entry.offset + sizeof(RunLogBlockHeader));
+        const uint64_t* sequence = reinterpret_cast<const uint64_t*>(timestamps + blockRows);
+        const float* columns = reinterpret_cast<const float*>(sequence + blockRows);
+        int numValues = std::min<int>(block.numValues, TELEMETRY_CHANNELS[channel].numValues);
+        for(uint32_t row = 0; row < block.rows; row++){
+            if(timestamps[row] < from || timestamps[row] > to)
+                continue;
+            record.timestamp = timestamps[row];
+            for(int i = 0; i < numValues; i++)
+                record.values[i] = columns[i*blockRows + row];
+            visit(record, sequence[row]);
+            visited++;
+        }
+    }
+    return visited;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <array>
+#include <functional>
+#include "sv_telemetry.h"
+
+namespace Service{
+
+    //columnar binary run log, one per run, written by the Writer thread and read by LSRunLog or analysis scripts
+    //layout, little endian as written by the host:
+    //  header: RunLogFileHeader
+    //  blocks: RunLogBlockHeader, float64 timestamps[blockRows], uint64 sequence[blockRows], then numValues columns of float32[blockRows]
+    //          each block holds one channel, blocks of different channels are interleaved in the order they were started
+    //          sequence counts every record appended to the log, so rows of different channels can be put back in write order
+    //  footer, only after a clean close: RunLogIndexEntry per block in file order, then RunLogTrailer
+    //a block's row count and time range are updated on every append, so a run that was killed can still be read by scanning the blocks
+    //time isnt assumed to increase, resets and checkpoint forks write earlier timestamps into the same log
+    const char RUNLOG_MAGIC[8] = {'L','S','R','U','N','L','O','G'};
+    const char RUNLOG_TRAILER_MAGIC[8] = {'L','S','R','U','N','E','N','D'};
+    const uint32_t RUNLOG_VERSION = 2;
+    const uint32_t RUNLOG_BLOCK_ROWS = 4096;
+    const uint32_t RUNLOG_BLOCK_MARKER = 0x4B4C4252; //"RBLK"
+
+    struct RunLogFileHeader{
+        char magic[8];
+        uint32_t version;
+        uint32_t blockRows;
+    };
+
+    struct RunLogBlockHeader{
+        uint32_t marker;
+        uint8_t channel;
+        uint8_t numValues;
+        uint16_t reserved;
+        uint32_t rows;
+        uint32_t reserved2;
+        double minTime;
+        double maxTime;
+    };
+
+    struct RunLogIndexEntry{
+        uint64_t offset;
+        RunLogBlockHeader block;
+    };
+
+    struct RunLogTrailer{
+        uint64_t indexOffset;
+        uint64_t numBlocks;
+        char magic[8];
+    };
+
+    static_assert(sizeof(RunLogFileHeader) == 16 && sizeof(RunLogBlockHeader) == 32 && sizeof(RunLogIndexEntry) == 40 && sizeof(RunLogTrailer) == 24,
+        "run log structs are written to disk as is");
+
+    size_t runLogBlockBytes(uint32_t blockRows, uint8_t numValues); //whole block including its header, a multiple of 8
+
+    //appends through a shared memory map that is grown in RUNLOG_GROW_BYTES steps, so a record is a few stores and no syscalls
+    //single threaded, only the Writer thread touches it
+    class RunLogWriter{
+        public:
+            RunLogWriter();
+            ~RunLogWriter();
+            RunLogWriter(const RunLogWriter&) = delete;
+            RunLogWriter& operator=(const RunLogWriter&) = delete;
+
+            bool open(const std::string& path); //replaces any existing file
+            bool isOpen(){return fd >= 0;};
+            void append(const TelemetryRecord& record);
+            void sync(); //asks the os to start writing dirty pages back, doesnt wait
+            void close(); //writes the footer index and trims the file to its real size
+
+        private:
+            const size_t RUNLOG_GROW_BYTES = 8*1024*1024;
+
+            int fd = -1;
+            char* mapped = nullptr;
+            size_t mappedSize = 0;
+            size_t used = 0; //end of the last block started
+            std::array<int64_t, NUM_TELEMETRY_CHANNELS> currentBlock; //offset of each channel's block being filled, -1 if none
+            std::vector<uint64_t> blockOffsets;
+            uint64_t nextSequence = 0;
+
+            bool reserve(size_t bytes); //makes sure used + bytes is mapped
+            int64_t startBlock(TelemetryChannel channel);
+    };
+
+    //maps a run log read only, uses the footer index if the log was closed cleanly and scans the blocks if not
+    class RunLogReader{
+        public:
+            RunLogReader(){};
+            ~RunLogReader();
+            RunLogReader(const RunLogReader&) = delete;
+            RunLogReader& operator=(const RunLogReader&) = delete;
+
+            bool open(const std::string& path); //false if the file cant be mapped or isnt a run log this build understands
+            void close();
+            bool hasIndex(){return indexed;}; //false if the run was killed before the log was closed
+            uint32_t getBlockRows(){return blockRows;};
+            const std::vector<RunLogIndexEntry>& getBlocks(){return blocks;};
+
+            //calls visit for every row of channel with from <= timestamp <= to, in the order they were written
+            //sequence is the row's place among every record in the log, whatever its channel
+            //blocks whose time range misses [from, to] are skipped without touching their columns, returns rows visited
+            size_t query(TelemetryChannel channel, double from, double to, const std::function<void(const TelemetryRecord&, uint64_t sequence)>& visit);
+
+        private:
+            int fd = -1;
+            const char* mapped = nullptr;
+            size_t mappedSize = 0;
+            uint32_t blockRows = 0;
+            bool indexed = false;
+            std::vector<RunLogIndexEntry> blocks;
+
+            bool readIndex();
+            void scanBlocks();
+    };
+}
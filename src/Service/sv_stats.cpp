@@ -0,0 +1,85 @@
+#include "sv_stats.h"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+Service::QuantileSketch::QuantileSketch(double relativeAccuracy){
+    gamma = (1 + relativeAccuracy)/(1 - relativeAccuracy);
+    logGamma = std::log(gamma);
+}
+
+//clamped before the cast, a very fine relativeAccuracy on a huge magnitude can put the index past int
+int Service::QuantileSketch::bucketIndex(double magnitude) const{
+    double index = std::ceil(std::log(magnitude)/logGamma);
+    return static_cast<int>(std::clamp<double>(index, std::numeric_limits<int>::lowest(), std::numeric_limits<int>::max()));
+}
+
+//the point in the bucket with the same relative error to both ends
+double Service::QuantileSketch::bucketValue(int index) const{
+    return 2*std::pow(gamma, index)/(gamma + 1);
+}
+
+void Service::QuantileSketch::add(double value){
+    if(!std::isfinite(value)){
+        nonFiniteCount++;
+        return;
+    }
+    if(value > MIN_INDEXED)
+        positive[bucketIndex(value)]++;
+    else if(value < -MIN_INDEXED)
+        negative[bucketIndex(-value)]++;
+    else
+        zeroCount++;
+
+    count++;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void Service::QuantileSketch::merge(const QuantileSketch& other){
+    for(const auto& [index, n] : other.positive)
+        positive[index] += n;
+    for(const auto& [index, n] : other.negative)
+        negative[index] += n;
+    zeroCount += other.zeroCount;
+    count += other.count;
+    nonFiniteCount += other.nonFiniteCount;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double Service::QuantileSketch::quantile(double q) const{
+    if(count == 0)
+        return 0;
+    uint64_t rank = static_cast<uint64_t>(std::clamp(q, 0.0, 1.0)*(count - 1));
+    if(rank == 0)
+        return min;
+    if(rank == count - 1)
+        return max;
+
+    //walk from the most negative value up, negative buckets go from largest magnitude down
+    double value = 0;
+    uint64_t seen = 0;
+    bool found = false;
+    for(auto it = negative.rbegin(); it != negative.rend() && !found; ++it){
+        seen += it->second;
+        if(seen > rank){
+            value = -bucketValue(it->first);
+            found = true;
+        }
+    }
+    if(!found){
+        seen += zeroCount;
+        found = seen > rank;
+    }
+    for(auto it = positive.begin(); it != positive.end() && !found; ++it){
+        seen += it->second;
+        if(seen > rank){
+            value = bucketValue(it->first);
+            found = true;
+        }
+    }
+    return std::clamp(value, min, max);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <limits>
+
+namespace Service{
+
+    //streaming summary of one metric, count, mean, min and max are exact, quantiles come from log spaced buckets
+    //a quantile is within relativeAccuracy of a value that was actually added, memory grows with log(max/min) rather than the sample count
+    //sketches can be merged, so parallel workers each keep their own and combine them at the end
+    class QuantileSketch{
+        public:
+            QuantileSketch(double relativeAccuracy = 0.01);
+
+            void add(double value); //nan and +-inf are only counted in getNonFiniteCount, they would have no bucket
+            void merge(const QuantileSketch& other); //other must use the same relativeAccuracy
+            double quantile(double q) const; //q in [0, 1], 0 if empty
+
+            uint64_t getCount() const{return count;};
+            uint64_t getNonFiniteCount() const{return nonFiniteCount;}; //rejected values, not part of count or any other stat
+            double getMean() const{return count > 0 ? sum/count : 0;};
+            double getMin() const{return count > 0 ? min : 0;};
+            double getMax() const{return count > 0 ? max : 0;};
+
+        private:
+            static constexpr double MIN_INDEXED = 1e-9; //magnitudes below this are counted as zero
+
+            double gamma;
+            double logGamma;
+            std::map<int, uint64_t> positive; //bucket i holds values in (gamma^(i-1), gamma^i]
+            std::map<int, uint64_t> negative; //same by magnitude
+            uint64_t zeroCount = 0;
+
+            uint64_t count = 0;
+            uint64_t nonFiniteCount = 0;
+            double sum = 0;
+            double min = std::numeric_limits<double>::max();
+            double max = std::numeric_limits<double>::lowest();
+
+            int bucketIndex(double magnitude) const;
+            double bucketValue(int index) const;
+    };
+}
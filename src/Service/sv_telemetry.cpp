@@ -0,0 +1,38 @@
+#include "sv_telemetry.h"
+#include <cstdio>
+
+int Service::findTelemetryChannel(const std::string& name){
+    for(int i = 0; i < NUM_TELEMETRY_CHANNELS; i++){
+        if(name == TELEMETRY_CHANNELS[i].name)
+            return i;
+    }
+    return -1;
+}
+
+//matches std::to_string(float/double) for single values and glm::to_string(vec3) for vectors
+static std::string toVec3Text(const float* values){
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "vec3(%f, %f, %f)", values[0], values[1], values[2]);
+    return buffer;
+}
+
+std::string Service::telemetryRecordToText(const TelemetryRecord& record){
+    const TelemetryChannelInfo& info = TELEMETRY_CHANNELS[record.channel];
+    std::string time = std::to_string(record.timestamp);
+
+    if(record.channel == TLM_EST_MATCH){
+        const float* v = record.values;
+        std::string prepend = "match" + std::to_string(static_cast<int>(v[0])) + ":" + time;
+        std::string text = prepend + ":estimation:" + toVec3Text(v + 1);
+        for(int i = 4; i < info.numValues; i++)
+            text += "\n" + prepend + ":" + info.columns[i] + ":" + std::to_string(v[i]);
+        return text;
+    }
+    if(record.channel == TLM_EST_FINAL)
+        return "FINAL ESTIMATION\n" + time + ":" + toVec3Text(record.values);
+
+    std::string text = time + ":";
+    if(info.label[0] != '\0')
+        text += std::string(info.label) + ":";
+    return text + toVec3Text(record.values);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Service{
+
+    //telemetry channels, one per kind of record, values are stored in the run log so only append new ones at the end
+    enum TelemetryChannel : uint8_t{
+        TLM_NAV = 0, //lander position during descent
+        TLM_THRUST, //commanded thrust during descent, lander local frame
+        TLM_GNC_ZEM, //zero effort miss
+        TLM_GNC_ZEV, //zero effort velocity
+        TLM_GNC_ACCEL, //ZEM/ZEV commanded acceleration, world frame
+        TLM_PRE_PROJECTED, //projected landing site position while waiting to descend
+        TLM_EST_MATCH, //first viable angular velocity estimate from an image match and the values it was made from
+        TLM_EST_FINAL, //final estimated angular velocity
+        NUM_TELEMETRY_CHANNELS
+    };
+
+    const int TELEMETRY_MAX_VALUES = 12;
+
+    //one sample, fixed size so producers never allocate, only the channel's numValues are stored
+    struct TelemetryRecord{
+        double timestamp;
+        TelemetryChannel channel;
+        float values[TELEMETRY_MAX_VALUES];
+    };
+
+    //how a channel is stored and how the offline tool names its columns and turns it back into the old text files
+    //a converted line is "timestamp:label:vec3(x, y, z)", the label part is left out if label is empty
+    //the estimate channels have their own multi line text format, see telemetryRecordToText
+    struct TelemetryChannelInfo{
+        const char* name;
+        const char* textFile;
+        const char* label;
+        uint8_t numValues;
+        const char* columns[TELEMETRY_MAX_VALUES];
+    };
+
+    const TelemetryChannelInfo TELEMETRY_CHANNELS[NUM_TELEMETRY_CHANNELS] = {
+        {"nav", "nav.txt", "", 3, {"x", "y", "z"}},
+        {"thrust", "thrust.txt", "", 3, {"x", "y", "z"}},
+        {"gnc_zem", "gnc.txt", "ZEM", 3, {"x", "y", "z"}},
+        {"gnc_zev", "gnc.txt", "ZEV", 3, {"x", "y", "z"}},
+        {"gnc_accel", "gnc.txt", "ZEMZEV_Accel", 3, {"x", "y", "z"}},
+        {"pre_projected", "preapproach.txt", "projectedposition", 3, {"x", "y", "z"}},
+        {"est_match", "estimates.txt", "", 12, {"match", "estimation_x", "estimation_y", "estimation_z", "pixelsmoved", "unitsmoved",
+            "radiusimg1", "radiusimg2", "avgradius", "altitudeimg1", "altitudeimg2", "avgaltitude"}},
+        {"est_final", "estimates.txt", "", 3, {"x", "y", "z"}},
+    };
+
+    int findTelemetryChannel(const std::string& name); //-1 if there is no channel with that name
+    std::string telemetryRecordToText(const TelemetryRecord& record); //same text the sim used to write, no trailing newline, only used offline
+}
@@ -0,0 +1,112 @@
+#include "sv_trace.h"
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+Service::Tracer& Service::Tracer::get(){
+    static Tracer tracer;
+    return tracer;
+}
+
+Service::Tracer::Tracer(): epoch{std::chrono::steady_clock::now()}{}
+
+uint64_t Service::Tracer::now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+Service::Tracer::ThreadBufferLease::~ThreadBufferLease(){
+    if(buffer == nullptr)
+        return;
+    Tracer& tracer = Tracer::get();
+    std::scoped_lock<std::mutex> lock(tracer.buffersLock);
+    buffer->inUse = false;
+}
+
+Service::Tracer::ThreadBuffer* Service::Tracer::getThreadBuffer(){
+    static thread_local ThreadBufferLease lease;
+    if(lease.buffer != nullptr)
+        return lease.buffer;
+
+    std::scoped_lock<std::mutex> lock(buffersLock);
+    for(std::unique_ptr<ThreadBuffer>& buffer : buffers){
+        if(!buffer->inUse){
+            buffer->inUse = true;
+            lease.buffer = buffer.get();
+            return lease.buffer;
+        }
+    }
+
+    std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+    buffer->threadId = buffers.size() + 1;
+    buffer->threadName = "thread " + std::to_string(buffer->threadId);
+    buffer->events = std::make_unique<TraceEvent[]>(EVENTS_PER_THREAD);
+    buffer->inUse = true;
+    lease.buffer = buffer.get();
+    buffers.push_back(std::move(buffer));
+    return lease.buffer;
+}
+
+void Service::Tracer::setThreadName(const std::string& name){
+    ThreadBuffer* buffer = getThreadBuffer();
+    std::scoped_lock<std::mutex> lock(buffersLock);
+    buffer->threadName = name;
+}
+
+//single producer, only the owning thread writes its buffer, the slot is published by the release store of writeIndex
+void Service::Tracer::record(const char* name, uint64_t startNs, uint64_t endNs){
+    ThreadBuffer* buffer = getThreadBuffer();
+    uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index % EVENTS_PER_THREAD];
+    event.name.store(name, std::memory_order_relaxed);
+    event.startNs.store(startNs, std::memory_order_relaxed);
+    event.durationNs.store(endNs - startNs, std::memory_order_relaxed);
+    buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+//events are left in the buffers, anything that started before the clear is skipped when writing
+void Service::Tracer::clear(){
+    clearedNs.store(now(), std::memory_order_relaxed);
+}
+
+bool Service::Tracer::writeChromeTrace(const std::string& path){
+    std::ofstream file(path);
+    if(!file.is_open())
+        return false;
+
+    uint64_t cleared = clearedNs.load(std::memory_order_relaxed);
+    std::scoped_lock<std::mutex> lock(buffersLock);
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for(std::unique_ptr<ThreadBuffer>& buffer : buffers){
+        file << (first ? "" : ",\n");
+        first = false;
+        file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadId << ", \"args\": {\"name\": \"" << buffer->threadName << "\"}}";
+
+        //copy the newest events out, then drop any the owning thread may have overwritten while we were copying
+        uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        std::vector<const char*> names;
+        std::vector<uint64_t> starts, durations;
+        for(uint64_t i = begin; i < end; i++){
+            TraceEvent& event = buffer->events[i % EVENTS_PER_THREAD];
+            names.push_back(event.name.load(std::memory_order_relaxed));
+            starts.push_back(event.startNs.load(std::memory_order_relaxed));
+            durations.push_back(event.durationNs.load(std::memory_order_relaxed));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire); //the copies above happen before this read of writeIndex
+        uint64_t endAfter = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t firstValid = endAfter >= EVENTS_PER_THREAD ? endAfter - EVENTS_PER_THREAD + 1 : 0;
+
+        for(uint64_t i = std::max(begin, firstValid); i < end; i++){
+            size_t n = i - begin;
+            if(starts[n] < cleared || names[n] == nullptr)
+                continue;
+            file << ",\n{\"name\": \"" << names[n] << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+                 << ", \"ts\": " << starts[n]/1000.0 << ", \"dur\": " << durations[n]/1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
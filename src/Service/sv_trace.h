@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Service{
+
+    //one completed zone, fields are relaxed atomics so writeChromeTrace can read a buffer while its thread keeps recording
+    struct TraceEvent{
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> startNs{0};
+        std::atomic<uint64_t> durationNs{0};
+    };
+
+    //scoped zone tracing, events go to a ring buffer owned by the recording thread so recording never takes a lock
+    //when a thread exits its buffer goes back to a pool for the next new thread, so the detached vision and readback threads
+    //share a few buffers instead of making one per image, each buffer is one track in the trace
+    //off by default, a disabled zone is one relaxed load
+    class Tracer{
+        public:
+            static Tracer& get();
+
+            void setEnabled(bool b){enabled.store(b, std::memory_order_relaxed);};
+            bool isEnabled(){return enabled.load(std::memory_order_relaxed);};
+            void setThreadName(const std::string& name); //names the calling thread's track
+
+            uint64_t now(); //ns since the tracer was created
+            void record(const char* name, uint64_t startNs, uint64_t endNs); //name must outlive the tracer, use string literals
+
+            //writes the newest events of every buffer as chrome trace json, open in chrome://tracing or ui.perfetto.dev
+            bool writeChromeTrace(const std::string& path);
+            void clear();
+
+            const uint32_t EVENTS_PER_THREAD = 16384; //oldest events are overwritten once a buffer is full
+
+        private:
+            Tracer();
+
+            struct ThreadBuffer{
+                uint32_t threadId;
+                std::string threadName;
+                std::unique_ptr<TraceEvent[]> events;
+                std::atomic<uint64_t> writeIndex{0}; //total events ever recorded, slot is writeIndex % EVENTS_PER_THREAD
+                bool inUse = false;
+            };
+
+            //returns the buffer to the pool when its thread exits
+            struct ThreadBufferLease{
+                ThreadBuffer* buffer = nullptr;
+                ~ThreadBufferLease();
+            };
+
+            std::atomic<bool> enabled{false};
+            std::chrono::steady_clock::time_point epoch;
+            std::atomic<uint64_t> clearedNs{0};
+
+            std::mutex buffersLock; //only taken when a thread records its first event, names itself or exits, and when writing
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+            ThreadBuffer* getThreadBuffer();
+    };
+
+    //records the time between construction and destruction as one event, only if tracing was on at construction
+    class TraceZone{
+        public:
+            TraceZone(const char* name): name{name}{
+                if(Tracer::get().isEnabled())
+                    startNs = Tracer::get().now() + 1; //+1 so a zone opened at the epoch isnt taken as disabled
+            };
+            ~TraceZone(){
+                if(startNs != 0)
+                    Tracer::get().record(name, startNs - 1, Tracer::get().now());
+            };
+        private:
+            const char* name;
+            uint64_t startNs = 0;
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+//times the rest of the enclosing scope, name should be a string literal
+#define TRACE_ZONE(name) Service::TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
@@ -0,0 +1,66 @@
+#include "sv_workerPool.h"
+#include <algorithm>
+
+Service::WorkerPool& Service::WorkerPool::shared(){
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+Service::WorkerPool::WorkerPool(unsigned numThreads){
+    for(unsigned t = 0; t < numThreads; t++)
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+Service::WorkerPool::~WorkerPool(){
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(std::thread& worker : workers)
+        worker.join();
+}
+
+void Service::WorkerPool::parallel(int threads, const std::function<void()>& job){
+    Batch batch;
+    batch.job = &job;
+    if(threads > 1){
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for(int t = 1; t < threads; t++)
+                tasks.push_back(Task{nullptr, &batch});
+        }
+        wake.notify_all();
+    }
+
+    job(); //calling thread takes work too
+
+    //batch lives on this stack, so nothing may still be queued or running against it when we return
+    std::unique_lock<std::mutex> guard(lock);
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [&](const Task& task){return task.batch == &batch;}), tasks.end());
+    batch.done.wait(guard, [&](){return batch.running == 0;});
+}
+
+//drains the queue before exiting, so a future handed out by submit is always fulfilled
+void Service::WorkerPool::workerLoop(){
+    std::unique_lock<std::mutex> guard(lock);
+    while(true){
+        wake.wait(guard, [&](){return stopping || !tasks.empty();});
+        if(tasks.empty())
+            return;
+        Task task = std::move(tasks.front());
+        tasks.pop_front();
+        if(task.batch)
+            task.batch->running++;
+        guard.unlock();
+
+        if(task.batch)
+            (*task.batch->job)();
+        else
+            task.run();
+
+        guard.lock();
+        if(task.batch && --task.batch->running == 0)
+            task.batch->done.notify_all();
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace Service{
+
+    //persistent worker threads, shared by the batched asteroid ray casts and the lidar scans
+    //so a batch of rays doesnt pay for creating and joining threads every time it is cast
+    //tasks run in the order they were queued, the pool is started on first use and joined at exit after running anything still queued
+    class WorkerPool{
+        public:
+            static WorkerPool& shared(); //hardware_concurrency threads
+            ~WorkerPool();
+
+            //calls job on the calling thread and on up to threads-1 workers, job has to share out the work itself (eg from an atomic counter)
+            //returns once every copy that started has finished, copies still queued when the caller's job returns are dropped
+            //so a busy pool only makes the batch run on fewer threads, and it is safe to call from a task
+            void parallel(int threads, const std::function<void()>& job);
+
+            //runs task on a worker, the future holds its result
+            template<typename F>
+            auto submit(F task) -> std::future<decltype(task())>{
+                auto packaged = std::make_shared<std::packaged_task<decltype(task())()>>(std::move(task));
+                std::future<decltype(task())> result = packaged->get_future();
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    tasks.push_back(Task{[packaged](){(*packaged)();}, nullptr});
+                }
+                wake.notify_one();
+                return result;
+            }
+        private:
+            WorkerPool(unsigned numThreads);
+
+            struct Batch{
+                const std::function<void()>* job;
+                int running = 0; //copies a worker has started, guarded by lock
+                std::condition_variable done;
+            };
+            struct Task{
+                std::function<void()> run; //submitted task, empty for a copy of a parallel job
+                Batch* batch;
+            };
+
+            std::mutex lock;
+            std::condition_variable wake;
+            std::deque<Task> tasks;
+            std::vector<std::thread> workers;
+            bool stopping = false;
+
+            void workerLoop();
+    };
+}
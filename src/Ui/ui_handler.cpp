@@ -4,6 +4,7 @@
 #include "world_stats.h"
 #include <thread>
 #include "vk_renderer_base.h"
+#include "sv_trace.h"
 #include <array>
 #include <glm/glm.hpp>
 #include <glm/gtx/string_cast.hpp>
@@ -45,6 +46,7 @@ UiHandler::~UiHandler(){}
 
 //main UI drawing method
 void UiHandler::drawUI(){
+    TRACE_ZONE("UiHandler::drawUI");
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -309,7 +311,11 @@ void UiHandler::gui_ShowOverlay(){
         ImGui::Text("SPACE cycles view focus\n");
         ImGui::Text("O toggles auto camera\n");
         ImGui::Text("P pauses simulation\n");
-        ImGui::Text("[ ] controls time\n\n");
+        ImGui::Text("[ ] controls time\n");
+        ImGui::Text("C toggles fixed step sim clock\n");
+        ImGui::Text("T toggles max speed time warp\n");
+        ImGui::Text("F5 saves checkpoint, F9 restores\n");
+        ImGui::Text("F8 starts/stops a trace capture\n\n");
 
         WorldStats& worldStats = r_mediator.physics_getWorldStats();
         Vk::RenderStats& renderStats = r_mediator.renderer_getRenderStats();
@@ -318,7 +324,12 @@ void UiHandler::gui_ShowOverlay(){
         ImGui::Text("Framerate: %.1f ms\n", renderStats.framerate);
         ImGui::Text("FPS: %.1f fps\n", renderStats.fps);
         ImGui::Text("Tickrate: %f\n", 0.0f);
-        ImGui::Text("Simulation Speed: %.1f x\n\n", worldStats.timeStepMultiplier);
+        if(worldStats.maxThroughput && worldStats.timeStepMultiplier != 0)
+            ImGui::Text("Simulation Speed: max\n");
+        else
+            ImGui::Text("Simulation Speed: %.1f x\n", worldStats.timeStepMultiplier);
+        ImGui::Text("Real Time Factor: %.1f x\n", worldStats.realTimeFactor);
+        ImGui::Text("Clock: %s\n\n", worldStats.simClock ? "fixed step" : "wall clock");
 
         ImGui::Text("\nLander\n");     
         ImGui::Separator();
@@ -92,6 +92,16 @@ void UiInput::processKey(int key, bool repeatKeypress){
             r_mediator.camera_toggleAutoCamera();
         if (key == GLFW_KEY_M)
             landingSiteInput = !landingSiteInput;
+        if (key == GLFW_KEY_C)
+            r_mediator.physics_toggleClockMode();
+        if (key == GLFW_KEY_T)
+            r_mediator.physics_toggleMaxThroughput();
+        if (key == GLFW_KEY_F5)
+            r_mediator.physics_quickSave();
+        if (key == GLFW_KEY_F9)
+            r_mediator.physics_quickLoad();
+        if (key == GLFW_KEY_F8)
+            r_mediator.application_toggleTraceCapture();
     }    
 }
 
@@ -1,4 +1,6 @@
 #include "vk_mesh.h"
+#include <stdexcept>
+#include <tiny_obj_loader.h> //implementation is defined in vk_renderer.cpp
 
 VertexInputDescription Vertex::get_vertex_description(){
     VertexInputDescription description;
@@ -59,4 +61,58 @@ VertexInputDescription Vertex::get_vertex_description(){
 
 bool Vertex::operator==(const Vertex& other) const { //used for testing equality when loading obj and storing unique vertices for indexing
     return pos == other.pos && normal == other.normal && texCoord == other.texCoord;
-}
\ No newline at end of file
+}
+
+void Vk::loadObjFile(const std::string& path, std::unordered_map<Vertex, uint32_t>& uniqueVertices, glm::vec3 baseColour,
+                    std::vector<Vertex>& allVertices, std::vector<uint32_t>& allIndices, Mesh& mesh){
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    if(!tinyobj::LoadObj(&attrib, &shapes, & materials, & warn, & err, path.c_str())){
+        throw std::runtime_error(warn + err);
+    }
+
+    mesh.indexBase = allIndices.size(); //start of indices will be 0 for first object
+
+    for(const auto& shape : shapes){
+        for(const auto& index : shape.mesh.indices){
+            Vertex vertex{};
+            //the index variable is of type tinyob::index_t which coontains vertex_index, normal_index and texcoord_index members
+            //we need to use these indexes to look up the actual vertex attributes in the attrib arrays
+            vertex.pos = { 
+                //because attrib vertices is an  array of float instead of a format we want like glm::vec3, we multiply the index by 3
+                //ie skipping xyz per vertex index. 
+                attrib.vertices[3 * index.vertex_index + 0], //offset 0 is X
+                attrib.vertices[3 * index.vertex_index + 1], //offset 1 is Y
+                attrib.vertices[3 * index.vertex_index + 2] //offset 2 is Z
+            };
+
+            vertex.texCoord = {
+                //Similarly there are two texture coordinate components per entry ie, U and V
+                attrib.texcoords[2 * index.texcoord_index + 0], //offset 0 is U
+                //because OBJ format assumes a coordinate system where a vertical coordinate of 0 means the bottom of the image,
+                1 - attrib.texcoords[2 * index.texcoord_index + 1] //offset 1 is V
+            };
+
+            //default vertex colour
+            vertex.colour = baseColour;
+
+            vertex.normal = {
+                attrib.normals[3 * index.normal_index + 0],
+                attrib.normals[3 * index.normal_index + 1],
+                attrib.normals[3 * index.normal_index + 2]
+                
+            };
+
+            //store unique vertices in an unnordered map
+            if(uniqueVertices.count(vertex) == 0){ //if vertices stored in uniqueVertices matching vertex == 0 
+                uniqueVertices[vertex] = static_cast<uint32_t>(allVertices.size()); //add the count of vertices to the map matching the vertex
+                allVertices.push_back(vertex); //add the vertex to vertices
+            }
+            allIndices.push_back(uniqueVertices[vertex]);
+        }
+    }
+    mesh.indexCount = allIndices.size() - mesh.indexBase; //how many indices in this model
+}
@@ -2,6 +2,8 @@
 
 #include "vk_types.h"
 #include <vector>
+#include <string>
+#include <unordered_map>
 #include <glm/vec3.hpp>
 
 //this all needs cleaner up or moved into relevant classes/namespaces?
@@ -64,4 +66,11 @@ namespace std {
                 return ((((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.colour) << 1)) >> 1) ^ (hash<glm::vec2>()(vertex.texCoord) << 1)) >> 1) ^ (hash<glm::vec3>()(vertex.normal) << 1);
             }
     };
- }
\ No newline at end of file
+ }
+
+namespace Vk{
+    //reads an obj file into the shared vertex and index arrays, filling in indexBase and indexCount of mesh
+    //used by Vk::Renderer and Headless::Renderer so both build identical allVertices/allIndices
+    void loadObjFile(const std::string& path, std::unordered_map<Vertex, uint32_t>& uniqueVertices, glm::vec3 baseColour,
+                    std::vector<Vertex>& allVertices, std::vector<uint32_t>& allIndices, Mesh& mesh);
+}
@@ -27,6 +27,7 @@
 #include <exception>
 #include "vk_pipeline.h"
 #include "vk_init_queries.h"
+#include "sv_trace.h"
 
 //rendering set up extending base renderer. Heavily based on code from this ebook https://raw.githubusercontent.com/Overv/VulkanTutorial/master/ebook/Vulkan%20Tutorial%20en.pdf
 
@@ -232,6 +233,7 @@ void Vk::Renderer::updateLightingData(GPUCameraData& camData){
 }
 
 void Vk::Renderer::drawFrame(){
+    TRACE_ZONE("Renderer::drawFrame");
     vkWaitForFences(device, 1, &_frames[currentFrame]._renderFence, VK_TRUE, UINT64_MAX); 
     
     //so the first step is to acquire an image from the swap chain
@@ -591,57 +593,8 @@ void Vk::Renderer::populateVerticesIndices(std::string path, std::unordered_map<
     Mesh mesh;
     _loadedMeshes.push_back(mesh);
     int numMeshes = _loadedMeshes.size() - 1;
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    if(!tinyobj::LoadObj(&attrib, &shapes, & materials, & warn, & err, path.c_str())){
-        throw std::runtime_error(warn + err);
-    }
-
     _loadedMeshes[numMeshes].id = numMeshes; //used in identify and indexing for draw calls into storage buffer
-    _loadedMeshes[numMeshes].indexBase = allIndices.size(); //start of indices will be 0 for first object
-
-    for(const auto& shape : shapes){
-        for(const auto& index : shape.mesh.indices){
-            Vertex vertex{};
-            //the index variable is of type tinyob::index_t which coontains vertex_index, normal_index and texcoord_index members
-            //we need to use these indexes to look up the actual vertex attributes in the attrib arrays
-            vertex.pos = { 
-                //because attrib vertices is an  array of float instead of a format we want like glm::vec3, we multiply the index by 3
-                //ie skipping xyz per vertex index. 
-                attrib.vertices[3 * index.vertex_index + 0], //offset 0 is X
-                attrib.vertices[3 * index.vertex_index + 1], //offset 1 is Y
-                attrib.vertices[3 * index.vertex_index + 2] //offset 2 is Z
-            };
-
-            vertex.texCoord = {
-                //Similarly there are two texture coordinate components per entry ie, U and V
-                attrib.texcoords[2 * index.texcoord_index + 0], //offset 0 is U
-                //because OBJ format assumes a coordinate system where a vertical coordinate of 0 means the bottom of the image,
-                1 - attrib.texcoords[2 * index.texcoord_index + 1] //offset 1 is V
-            };
-
-            //default vertex colour
-            vertex.colour = baseColour;
-
-            vertex.normal = {
-                attrib.normals[3 * index.normal_index + 0],
-                attrib.normals[3 * index.normal_index + 1],
-                attrib.normals[3 * index.normal_index + 2]
-                
-            };
-
-            //store unique vertices in an unnordered map
-            if(uniqueVertices.count(vertex) == 0){ //if vertices stored in uniqueVertices matching vertex == 0 
-                uniqueVertices[vertex] = static_cast<uint32_t>(allVertices.size()); //add the count of vertices to the map matching the vertex
-                allVertices.push_back(vertex); //add the vertex to vertices
-            }
-            allIndices.push_back(uniqueVertices[vertex]);
-        }
-    }
-    _loadedMeshes[numMeshes].indexCount = allIndices.size() - _loadedMeshes[numMeshes].indexBase; //how many indices in this model
+    Vk::loadObjFile(path, uniqueVertices, baseColour, allVertices, allIndices, _loadedMeshes[numMeshes]);
 }
 
 //used to pass vertices and indices to WorldState for building collision meshes from objects directly (only used for asteroid mesh)
@@ -37,7 +37,6 @@ public:
 
     void init() override;
 
-    void setShouldDrawOffscreen(bool b);
     void writeOffscreenImageToDisk(); 
 
 protected:
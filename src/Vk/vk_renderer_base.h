@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <vector>
 #include <vk_mem_alloc.h>
+#include "sv_iRenderEngine.h"
 
 class UiHandler; //forward declare
 class WorldPhysics;
@@ -36,7 +37,7 @@ namespace Vk{
         double fps = 0;
     };
 
-    class RendererBase{
+    class RendererBase : public IRenderEngine{
     public:
 
         RenderStats renderStats;
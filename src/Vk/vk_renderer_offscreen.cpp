@@ -8,6 +8,9 @@
 #include <stb_image_write.h>
 #include "vk_init_queries.h"
 #include "vk_pipeline.h"
+#include "sv_trace.h"
+#include "obj_lander.h"
+#include <algorithm>
 
 //Offscreen rendering set up, used to simulate the lander optical camera
 //derived from vk_renderer, optionally performs offscreen rending, and runs renderer class
@@ -26,7 +29,7 @@ void Vk::OffscreenRenderer::init(){
     imguiTextureSetIndicesQueue.resize(0);
     imguiDetectionIndicesQueue.resize(0);
     imguiMatchIndicesQueue.resize(0);
-    cvMatQueue.resize(0);
+    cvMatQueues.clear();
    
     imguiTexturePackets.resize(NUM_TEXTURE_SETS*NUM_TEXTURES_IN_SET+1); //+1 for the match image
     detectionImageMappings.resize(NUM_TEXTURE_SETS);
@@ -477,7 +480,9 @@ void Vk::OffscreenRenderer::createOffscreenRenderPass(){
 
 //take the last VKImage output by offscreen pass, convert it to linear format so we can read it
 //adapted from Sascha Willems screenshot example https://github.com/SaschaWillems/Vulkan/blob/master/examples/screenshot/screenshot.cpp
-void Vk::OffscreenRenderer::convertOffscreenImage(){
+void Vk::OffscreenRenderer::convertOffscreenImage(int landerSlot){
+    TRACE_ZONE("OffscreenRenderer::convertOffscreenImage");
+    std::scoped_lock<std::mutex> lock(copyLock); //before touching offscreenCommandPool, command pools arent thread safe and drawFrame records from it
     opticsFrameCounter = (opticsFrameCounter + 1) % NUM_TEXTURE_SETS;
         
     VkCommandBufferAllocateInfo cmdBufAllocateInfo{};
@@ -491,8 +496,6 @@ void Vk::OffscreenRenderer::convertOffscreenImage(){
     VkCommandBufferBeginInfo cmdBufInfo = Vk::Structures::command_buffer_begin_info(0);
     vkBeginCommandBuffer(cmdBuffer, &cmdBufInfo);
 
-    std::scoped_lock<std::mutex> lock(copyLock);
-
     //prepare grey transition image
     imageHelper->insertImageMemoryBarrier(
         cmdBuffer,
@@ -644,8 +647,9 @@ void Vk::OffscreenRenderer::convertOffscreenImage(){
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         VkImageSubresourceRange{ VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 });
 
-    //gui image is now ready to show again
-    imguiTextureSetIndicesQueue.push_back(opticsFrameCounter);
+    //gui image is now ready to show again, the ui only follows the primary lander
+    if(landerSlot == 0)
+        imguiTextureSetIndicesQueue.push_back(opticsFrameCounter);
     //this is only for the optics texture though, might have to make 2 of these indices queues?
 
     imageHelper->insertImageMemoryBarrier(
@@ -684,9 +688,13 @@ void Vk::OffscreenRenderer::convertOffscreenImage(){
 
     flushCommandBuffer(cmdBuffer, graphicsQueue, offscreenCommandPool, false);    
 
-    //wrap the mapped memory to an opencv mat
+    //wrap the mapped memory to an opencv mat, copied out because the next lander's image is written to the same memory
     cv::Mat wrappedMat = cv::Mat(OUTPUT_IMAGE_WH, OUTPUT_IMAGE_WH, CV_8UC4, (void*)dstImageMappedData, cv::Mat::AUTO_STEP);
-    cvMatQueue.push_back(wrappedMat);
+    {
+        std::scoped_lock<std::mutex> queueLock(queueSubmitMutex);
+        cvMatQueues[landerSlot].push_back(wrappedMat.clone());
+    }
+    conversionInFlight = false; //offscreenImage and the mapped memory are free for the next lander's render
 }
 
 //used to assign material of feature detection image, used to render opencv output on ui
@@ -718,13 +726,18 @@ void Vk::OffscreenRenderer::clearOpticsViews(){
     imguiTextureSetIndicesQueue.clear();
 }
 
-void Vk::OffscreenRenderer::setShouldDrawOffscreen(bool b){
-    shouldDrawOffscreenFrame = b;
+//a lander has at most one request waiting, false withdraws it
+void Vk::OffscreenRenderer::setShouldDrawOffscreen(bool b, int landerSlot){
+    auto it = std::find(pendingOpticsLanders.begin(), pendingOpticsLanders.end(), landerSlot);
+    if(b && it == pendingOpticsLanders.end())
+        pendingOpticsLanders.push_back(landerSlot);
+    else if(!b && it != pendingOpticsLanders.end())
+        pendingOpticsLanders.erase(it);
 }
 
 //update the lander camera pos and orientation data for passing to shaders
 void Vk::OffscreenRenderer::populateLanderCameraData(GPUCameraData& camData){
-    RenderObject* lander =  p_renderables->at(2).get(); //lander is obj 2
+    LanderObj* lander = r_mediator.scene_getLanderObject(opticsLander);
     glm::vec3 camPos = lander->pos;
 
     glm::mat4 view = glm::lookAt(camPos, camPos - lander->up, lander->forward); //setting view to look forward
@@ -738,16 +751,20 @@ void Vk::OffscreenRenderer::populateLanderCameraData(GPUCameraData& camData){
 }
 
 void Vk::OffscreenRenderer::drawFrame(){
-    if (shouldDrawOffscreenFrame){
+    //one image in flight at a time, from render until it is converted and queued
+    //landers that asked on the same tick are drawn on the following frames
+    if (!pendingOpticsLanders.empty() && !renderSubmitted && !conversionInFlight){
         std::scoped_lock<std::mutex> lock(copyLock); //must wait for any in progress copy operation
-        shouldDrawOffscreenFrame = false;
+        opticsLander = pendingOpticsLanders.front();
+        pendingOpticsLanders.pop_front();
         recordCommandBuffer_Offscreen();
         renderSubmitted = true;
     }
 
     if(renderSubmitted){//this just stops us checking for fence if we know a new render wasnt submitted since the last one
         if(vkGetFenceStatus(device, offscreenCopyFence) == VK_SUCCESS){ //if offscreen render fence has been signalled then
-            std::thread thread(&Vk::OffscreenRenderer::convertOffscreenImage, this); //we run the conversions in a seperate thread, reduces stuttering
+            conversionInFlight = true;
+            std::thread thread(&Vk::OffscreenRenderer::convertOffscreenImage, this, opticsLander); //we run the conversions in a seperate thread, reduces stuttering
             thread.detach();   
             //convertOffscreenImage();
             renderSubmitted = false;
@@ -865,14 +882,25 @@ std::vector<ImguiTexturePacket>& Vk::OffscreenRenderer::getDstTexturePackets(){
     return imguiTexturePackets;
 }
 
-void Vk::OffscreenRenderer::popCvMatQueue(){
+void Vk::OffscreenRenderer::popCvMatQueue(int landerSlot){
+    std::scoped_lock<std::mutex> lock(queueSubmitMutex); 
+    cvMatQueues[landerSlot].pop_front(); 
+}
+
+cv::Mat& Vk::OffscreenRenderer::frontCvMatQueue(int landerSlot){
+    std::scoped_lock<std::mutex> lock(queueSubmitMutex); 
+    return cvMatQueues[landerSlot].front();
+}
+
+bool Vk::OffscreenRenderer::cvMatQueueEmpty(int landerSlot){
     std::scoped_lock<std::mutex> lock(queueSubmitMutex); 
-    cvMatQueue.pop_front(); 
+    auto it = cvMatQueues.find(landerSlot);
+    return it == cvMatQueues.end() || it->second.empty();
 }
 
-cv::Mat& Vk::OffscreenRenderer::frontCvMatQueue(){
+void Vk::OffscreenRenderer::clearCvMatQueue(int landerSlot){
     std::scoped_lock<std::mutex> lock(queueSubmitMutex); 
-    return cvMatQueue.front();
+    cvMatQueues.erase(landerSlot);
 }
 
 void Vk::OffscreenRenderer::mapLightingDataToGPU(){
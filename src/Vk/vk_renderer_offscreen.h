@@ -2,6 +2,8 @@
 #include "vk_renderer.h"
 #include "opencv2/opencv.hpp"
 #include <array>
+#include <unordered_map>
+#include <atomic>
 
 class GLFWwindow;
 class Mediator;
@@ -13,7 +15,8 @@ public:
 
     void init() override;
     void drawFrame(); //draw a frame
-    void setShouldDrawOffscreen(bool b);
+    void setShouldDrawOffscreen(bool b, int landerSlot);
+    bool isOpticsFramePending(){return !pendingOpticsLanders.empty() || renderSubmitted;};
     void cleanup();
     
     std::vector<ImguiTexturePacket>& getDstTexturePackets();
@@ -24,10 +27,10 @@ public:
 
     std::deque<int> getImguiMatchIndicesQueue(){return imguiMatchIndicesQueue;};
 
-    void popCvMatQueue();
-    cv::Mat& frontCvMatQueue();
-
-    bool cvMatQueueEmpty(){return cvMatQueue.empty();};
+    void popCvMatQueue(int landerSlot);
+    cv::Mat& frontCvMatQueue(int landerSlot);
+    bool cvMatQueueEmpty(int landerSlot);
+    void clearCvMatQueue(int landerSlot);
 
     void assignMatToDetectionView(cv::Mat image);
     void assignMatToMatchingView(cv::Mat image);
@@ -57,11 +60,11 @@ private:
 
     Texture matchTexture;
 
-    std::deque<cv::Mat> cvMatQueue;
+    std::unordered_map<int, std::deque<cv::Mat>> cvMatQueues; //finished images by lander slot, guarded by queueSubmitMutex
 
     int opticsFrameCounter = NUM_TEXTURE_SETS-1; //start at max, instantly go to zero at start of copying, allows syncing
 
-    void convertOffscreenImage();
+    void convertOffscreenImage(int landerSlot);
 
     //too much work to rewrite render pipeline and everything that goes with it to output lower resolution natively, too messy, need to start from scratch but not in this project
     //instead we render in the full window size (need to check window size this is set statically for now)
@@ -152,8 +155,10 @@ private:
     VkDescriptorSet os_lightSet;
     VkDescriptorSetLayout os_lightSetLayout;
     
-    bool shouldDrawOffscreenFrame = false;
+    std::deque<int> pendingOpticsLanders; //lander slots waiting for an optics image, one is drawn at a time
+    int opticsLander = 0; //slot the image being drawn is for, populateLanderCameraData looks through its camera
     bool renderSubmitted = false;
+    std::atomic<bool> conversionInFlight{false}; //set when the convert thread is started, it clears it once the image is queued, no new render until then
     
     void recordCommandBuffer_Offscreen();
 
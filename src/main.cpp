@@ -1,7 +1,10 @@
 #include "application.h"
 
 //entry point, all program flow is handled by Application class
-int main(){
+//LSApp [replay file], with a replay file the recorded run is played back instead of simulated
+int main(int argc, char* argv[]){
     Application app = Application();
+    if(argc > 1)
+        app.setReplayFile(argv[1]);
     return app.run();
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "hl_application.h"
+#include "hl_campaign.h"
+#include "sv_randoms.h"
+#include "sv_trace.h"
+#include <iostream>
+#include <string>
+
+//entry point for headless batch runs, usage: LSHeadless [scenario 0-3] [max sim seconds] [runs] [workers] [seed] [forks] [trace file] [run output] [physics workers]
+//scenario 0 is the default scene data, 1-3 match the scenario buttons in the ui
+//if runs > 1 the scenario is repeated as a campaign across workers (0 workers uses all cores), randomised scenarios give a monte carlo sweep
+//campaign run i is seeded with seed+i, so a single run can be replayed with LSHeadless [scenario] [max sim seconds] 1 0 [seed from summary]
+//seed 0 (default) picks a fresh seed
+//forks > 0 runs a single scenario up to the start of descent once, then replays the descent that many times from a checkpoint
+//with no controller changes every fork should land identically, which is a quick check that restores are exact
+//if a trace file is given, trace zones are recorded for the whole invocation and written as chrome trace json on exit, - for none
+//run output 0 skips the per run text, run log and images of a campaign, the summary stats are measured in process either way
+//physics workers > 0 steps single runs and forks in a multithreaded bullet world (LS_BULLET_MT builds), campaigns ignore it
+int main(int argc, char* argv[]){
+    int scenario = 0;
+    double maxSimSeconds = 3600.0;
+    int runs = 1;
+    int workers = 0;
+    uint64_t seed = 0;
+    int forks = 0;
+    std::string tracePath;
+    bool runOutput = true;
+    int physicsWorkers = 0;
+    try{
+        if(argc > 1)
+            scenario = std::stoi(argv[1]);
+        if(argc > 2)
+            maxSimSeconds = std::stod(argv[2]);
+        if(argc > 3)
+            runs = std::stoi(argv[3]);
+        if(argc > 4)
+            workers = std::stoi(argv[4]);
+        if(argc > 5)
+            seed = std::stoull(argv[5]);
+        if(argc > 6)
+            forks = std::stoi(argv[6]);
+        if(argc > 7 && std::string(argv[7]) != "-")
+            tracePath = argv[7];
+        if(argc > 8)
+            runOutput = std::stoi(argv[8]) != 0;
+        if(argc > 9)
+            physicsWorkers = std::stoi(argv[9]);
+    }
+    catch (const std::exception &e){
+        std::cerr << "usage: LSHeadless [scenario 0-3] [max sim seconds] [runs] [workers] [seed] [forks] [trace file] [run output] [physics workers]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    SceneData sceneData;
+    switch(scenario){
+        case 1: sceneData = ScenarioData_Scenario1(); break;
+        case 2: sceneData = ScenarioData_Scenario2(); break;
+        case 3: sceneData = ScenarioData_Scenario3(); break;
+        default: break;
+    }
+
+    sceneData.SEED = seed;
+
+    //written on every return path below
+    struct TraceWriter{
+        std::string path;
+        ~TraceWriter(){
+            if(path.empty())
+                return;
+            Service::Tracer::get().setEnabled(false);
+            if(Service::Tracer::get().writeChromeTrace(path))
+                std::cout << "Trace written to " << path << "\n";
+            else
+                std::cerr << "Could not write trace to " << path << std::endl;
+        }
+    } traceWriter{tracePath};
+    if(!tracePath.empty()){
+        Service::Tracer::get().setThreadName("main");
+        Service::Tracer::get().setEnabled(true);
+    }
+
+    //campaign workers each step their own world, bullet's task scheduler is shared and only one thread can drive it
+    if(runs > 1 && physicsWorkers > 0)
+        std::cout << "Physics workers are ignored in campaigns, each run already has its own worker\n";
+    else
+        WorldPhysics::setBulletThreading(physicsWorkers);
+
+    if(runs > 1){
+        if(seed == 0)
+            seed = Service::getFreshSeed();
+        std::vector<SceneData> variants(runs, sceneData);
+        for(int i = 0; i < runs; i++)
+            variants[i].SEED = seed + i;
+        Headless::Campaign campaign = Headless::Campaign(workers);
+        campaign.setRunOutput(runOutput);
+        std::vector<Headless::CampaignRunResult> results = campaign.run(variants, maxSimSeconds);
+        campaign.printSummary(results);
+        return EXIT_SUCCESS;
+    }
+
+    if(forks > 0){
+        try{
+            Headless::Application app = Headless::Application();
+            if(!app.runToDescent(sceneData, maxSimSeconds)){
+                std::cerr << "Lander did not reach descent before " << maxSimSeconds << "s" << std::endl;
+                return EXIT_FAILURE;
+            }
+            std::cout << "Descent checkpoint at: " << app.getCheckpointTime() << "s\n";
+            for(int i = 0; i < forks; i++){
+                Headless::RunResult result = app.runFromCheckpoint(maxSimSeconds);
+                std::cout << "Fork " << i << ": sim time " << result.simSeconds << "s, wall time " << result.wallSeconds << "s, collided " << result.landerCollided << "\n";
+            }
+            app.endForks();
+        }
+        catch (const std::exception &e){
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    try{
+        Headless::Application app = Headless::Application();
+        Headless::RunResult result = app.run(sceneData, maxSimSeconds);
+        std::cout << "Seed: " << result.seed << "\n";
+        std::cout << "Sim time: " << result.simSeconds << "s\n";
+        std::cout << "Wall time: " << result.wallSeconds << "s\n";
+        std::cout << "Real time factor: " << result.realTimeFactor << "x\n";
+        std::cout << "Lander collided: " << result.landerCollided << "\n";
+        if(result.landerCollided){
+            std::cout << "Touchdown error: " << result.touchdownError << "m\n";
+            std::cout << "Peak impact: " << result.peakImpactForce << "N\n";
+        }
+        std::cout << "Delta-v: " << result.totalDeltaV << "m/s\n";
+        if(result.hasSpinEstimate)
+            std::cout << "Spin estimate error: " << result.spinEstimateError << "rad/s\n";
+    }
+    catch (const std::exception &e){
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+#include "sv_runlog.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+
+//offline tool for the columnar run log written to output/nav/runlog.lsr
+//usage: LSRunLog [run log] info
+//       LSRunLog [run log] csv [channel] [from] [to]     csv of one channel on stdout, optionally only from <= timestamp <= to
+//       LSRunLog [run log] text [output folder]          regenerates nav.txt, thrust.txt, gnc.txt, preapproach.txt and estimates.txt
+//the text output folder defaults to the folder the run log is in, existing text files are replaced
+//channels that shared a text file are interleaved back into the order the sim wrote them
+//a run that was killed still reads, the blocks are scanned when there is no footer index
+
+static void printUsage(){
+    std::cerr << "usage: LSRunLog [run log] info\n"
+                 "       LSRunLog [run log] csv [channel] [from] [to]\n"
+                 "       LSRunLog [run log] text [output folder]\n"
+                 "channels:";
+    for(int i = 0; i < Service::NUM_TELEMETRY_CHANNELS; i++)
+        std::cerr << " " << Service::TELEMETRY_CHANNELS[i].name;
+    std::cerr << std::endl;
+}
+
+static void printInfo(Service::RunLogReader& log){
+    std::cout << "Index: " << (log.hasIndex() ? "footer" : "none, blocks scanned") << "\n";
+    std::cout << "Blocks: " << log.getBlocks().size() << " of " << log.getBlockRows() << " rows\n";
+    for(int i = 0; i < Service::NUM_TELEMETRY_CHANNELS; i++){
+        size_t rows = 0;
+        double minTime = std::numeric_limits<double>::max();
+        double maxTime = std::numeric_limits<double>::lowest();
+        for(const Service::RunLogIndexEntry& entry : log.getBlocks()){
+            if(entry.block.channel != i || entry.block.rows == 0)
+                continue;
+            rows += entry.block.rows;
+            minTime = std::min(minTime, entry.block.minTime);
+            maxTime = std::max(maxTime, entry.block.maxTime);
+        }
+        if(rows > 0)
+            std::cout << Service::TELEMETRY_CHANNELS[i].name << ": " << rows << " rows, " << minTime << "s to " << maxTime << "s\n";
+    }
+}
+
+static void writeCsv(Service::RunLogReader& log, Service::TelemetryChannel channel, double from, double to){
+    const Service::TelemetryChannelInfo& info = Service::TELEMETRY_CHANNELS[channel];
+    std::cout << "timestamp";
+    for(int i = 0; i < info.numValues; i++)
+        std::cout << "," << info.columns[i];
+    std::cout << "\n";
+
+    char buffer[32];
+    log.query(channel, from, to, [&](const Service::TelemetryRecord& record, uint64_t){
+        std::snprintf(buffer, sizeof(buffer), "%.6f", record.timestamp);
+        std::cout << buffer;
+        for(int i = 0; i < info.numValues; i++){
+            std::snprintf(buffer, sizeof(buffer), ",%.9g", record.values[i]);
+            std::cout << buffer;
+        }
+        std::cout << "\n";
+    });
+}
+
+//lines are gathered per file and sorted by the log's sequence column, so eg ZEM, ZEV and Accel lines come out tick by tick
+static size_t writeText(Service::RunLogReader& log, const std::filesystem::path& outPath){
+    if(!outPath.empty())
+        std::filesystem::create_directories(outPath);
+
+    std::map<std::string, std::vector<std::pair<uint64_t, std::string>>> lines;
+    size_t count = 0;
+    for(int i = 0; i < Service::NUM_TELEMETRY_CHANNELS; i++){
+        std::vector<std::pair<uint64_t, std::string>>& fileLines = lines[Service::TELEMETRY_CHANNELS[i].textFile];
+        count += log.query(static_cast<Service::TelemetryChannel>(i), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(),
+            [&](const Service::TelemetryRecord& record, uint64_t sequence){
+                fileLines.emplace_back(sequence, Service::telemetryRecordToText(record));
+            });
+    }
+
+    for(auto& [textFile, fileLines] : lines){
+        std::sort(fileLines.begin(), fileLines.end(), [](const auto& a, const auto& b){return a.first < b.first;});
+        std::ofstream file(outPath / textFile, std::ios::trunc);
+        if(!file.is_open()){
+            std::cerr << "Unable to open " << (outPath / textFile) << std::endl;
+            continue;
+        }
+        for(const auto& line : fileLines)
+            file << line.second << "\n";
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]){
+    if(argc < 3){
+        printUsage();
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path logPath = argv[1];
+    std::string command = argv[2];
+
+    Service::RunLogReader log;
+    if(!log.open(logPath.string())){
+        std::cerr << logPath << " is not a run log or was written by a different version" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(command == "info"){
+        printInfo(log);
+        return EXIT_SUCCESS;
+    }
+
+    if(command == "csv" && argc > 3){
+        int channel = Service::findTelemetryChannel(argv[3]);
+        if(channel < 0){
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        double from = std::numeric_limits<double>::lowest();
+        double to = std::numeric_limits<double>::max();
+        try{
+            if(argc > 4)
+                from = std::stod(argv[4]);
+            if(argc > 5)
+                to = std::stod(argv[5]);
+        }
+        catch (const std::exception &e){
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        writeCsv(log, static_cast<Service::TelemetryChannel>(channel), from, to);
+        return EXIT_SUCCESS;
+    }
+
+    if(command == "text"){
+        std::filesystem::path outPath = argc > 3 ? std::filesystem::path(argv[3]) : logPath.parent_path();
+        size_t count = writeText(log, outPath);
+        std::cout << "Converted " << count << " records to " << (outPath.empty() ? std::filesystem::path(".") : outPath) << "\n";
+        return EXIT_SUCCESS;
+    }
+
+    printUsage();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,60 @@
+#include <catch.hpp>
+#include "sv_polyhedronGravity.h"
+#include "vk_mesh.h"
+#include <cmath>
+
+//unit cube centred on the origin, G*rho = 1 so its mass is 1
+static Service::PolyhedronGravity buildUnitCube(){
+    std::vector<Vertex> vertices(8);
+    for(int i = 0; i < 8; i++)
+        vertices[i].pos = glm::vec3((i & 1) - 0.5f, ((i >> 1) & 1) - 0.5f, ((i >> 2) & 1) - 0.5f);
+    std::vector<uint32_t> indices = {
+        0,2,3, 0,3,1,  4,5,7, 4,7,6,  0,1,5, 0,5,4,
+        2,6,7, 2,7,3,  0,4,6, 0,6,2,  1,3,7, 1,7,5
+    };
+    Service::PolyhedronGravity cube;
+    cube.build(vertices, indices, 0, indices.size(), glm::vec3(1.0f));
+    cube.setDensityConstant(1.0);
+    return cube;
+}
+
+//central difference divergence of the field, Poisson says -4*pi*G*rho inside the body and 0 outside
+static double fieldDivergence(const Service::PolyhedronGravity& model, const glm::dvec3& point){
+    const double h = 1e-3;
+    double divergence = 0;
+    for(int axis = 0; axis < 3; axis++){
+        glm::dvec3 step(0.0);
+        step[axis] = h;
+        divergence += (model.evaluate(point + step)[axis] - model.evaluate(point - step)[axis])/(2*h);
+    }
+    return divergence;
+}
+
+TEST_CASE("PolyhedronGravityUnitCubeShape") {
+    Service::PolyhedronGravity cube = buildUnitCube();
+    CHECK(cube.getVolume() == Approx(1.0));
+    CHECK(cube.getBoundingRadius() == Approx(std::sqrt(0.75)));
+    CHECK(cube.getOpenEdgeCount() == 0);
+
+    glm::dvec3 centre = cube.evaluate(glm::dvec3(0.0));
+    CHECK(glm::length(centre) < 1e-12);
+}
+
+TEST_CASE("PolyhedronGravityPointMassLimit") {
+    Service::PolyhedronGravity cube = buildUnitCube();
+    for(glm::dvec3 point : {glm::dvec3(100, 0, 0), glm::dvec3(60, -50, 30), glm::dvec3(0, 0, -250)}){
+        double r = glm::length(point);
+        glm::dvec3 pointMass = -point/(r*r*r);
+        glm::dvec3 g = cube.evaluate(point);
+        CHECK(glm::length(g - pointMass) < 1e-6*glm::length(pointMass));
+    }
+}
+
+TEST_CASE("PolyhedronGravityLaplacian") {
+    Service::PolyhedronGravity cube = buildUnitCube();
+    double inside = fieldDivergence(cube, glm::dvec3(0.1, 0.2, -0.15));
+    double outside = fieldDivergence(cube, glm::dvec3(2.0, 1.0, 0.5));
+    CHECK(inside < 0);
+    CHECK(inside == Approx(-4*M_PI).epsilon(1e-4));
+    CHECK(std::abs(outside) < 1e-6);
+}